@@ -98,3 +98,10 @@ settings.cc.Output = Intermediate_Output
 
 objects = Compile(settings, source)
 exe = Link(settings, "pathfinder", objects)
+
+-- ipb2ffx, converts the binary output (--ob) back to FFX, does not depend on OTAWA
+ipb_settings = NewSettings()
+ipb_settings.cc.flags:Add("-Wall") -- only depends on the C library, so it builds without warnings
+ipb_settings.cc.flags:Add("-O" .. config.O.value)
+ipb_settings.cc.Output = Intermediate_Output
+ipb2ffx = Link(ipb_settings, "ipb2ffx", Compile(ipb_settings, Collect("src/ipb/*.cpp")))
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Compare the two iteration strategies of the v3 analysis (working list, and weak topological order with --wto)
+# on the benchmarks with loops: for each program and strategy, prints the time, the blocks processed and the infeasible paths.
+# Both strategies must find the same infeasible paths; the WTO one should process fewer blocks on nested loops.
+# Usage, from benchmarks/: ./compare_wto.sh [path to pathfinder] [extra pathfinder options]
+PATHFINDER=${1:-../pathfinder}
+PATHFINDER=$(cd "$(dirname "$PATHFINDER")" && pwd)/$(basename "$PATHFINDER") # the runs are done in a temporary directory
+[ $# -gt 0 ] && shift
+BENCHMARKS=$(pwd)
+PROGRAMS="simple_loop/simple_loop.elf loop_test/loop_test.elf loop_test/loop_test2.elf loop_test/loop_test3.elf
+	armelle/main.elf continental/an_is.elf emulating_function/div7.elf
+	sparse-withloop/sparse8.arm sparse-withloop/sparse16.arm sparse-withloop/sparse32.arm"
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+printf "%-36s %-4s %10s %10s %6s\n" program mode time_ms blocks ips
+for p in $PROGRAMS; do
+	for mode in wl wto; do
+		[ $mode = wto ] && opt=--wto || opt=
+		start=$(date +%s%N)
+		if ! (cd "$TMP" && "$PATHFINDER" -3 $opt -o true --telemetry "$@" "$BENCHMARKS/$p" main > log 2>&1); then
+			printf "%-36s %-4s %10s\n" "$p" $mode failed
+			continue
+		fi
+		end=$(date +%s%N)
+		blocks=$(sed -n 's/.*"blocks_processed": \([0-9]*\).*/\1/p' "$TMP/main_telemetry.json")
+		ips=$(grep -c "<not-all" "$TMP/main_ips.ffx")
+		printf "%-36s %-4s %10d %10s %6s\n" "$p" $mode $(( (end - start) / 1000000 )) "$blocks" "$ips"
+	done
+done
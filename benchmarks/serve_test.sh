@@ -0,0 +1,45 @@
+#!/bin/sh
+# Check the server mode on two_callers, where f has several callers and its summary is shared by all of them:
+# the same requests are sent twice (the second time from the resident summaries), then another entry and back,
+# every request must be answered with "ok" and the same number of infeasible paths as a single run.
+# Usage, from benchmarks/: ./serve_test.sh [path to pathfinder]
+# two_callers/two_callers.elf is built from two_callers.c with the ARM toolchain, as the other benchmarks.
+PATHFINDER=${1:-../pathfinder}
+PATHFINDER=$(cd "$(dirname "$PATHFINDER")" && pwd)/$(basename "$PATHFINDER") # the single run is done in a temporary directory
+PROGRAM=$(pwd)/two_callers/two_callers.elf
+TMP=$(mktemp -d)
+SOCKET=$TMP/pathfinder.sock
+trap 'kill $SERVER 2>/dev/null; rm -rf "$TMP"' EXIT
+
+request() {
+	python3 -c 'import socket, sys
+s = socket.socket(socket.AF_UNIX)
+s.connect(sys.argv[1])
+s.sendall((sys.argv[2] + "\n").encode())
+sys.stdout.write(s.makefile().readline())' "$SOCKET" "$1"
+}
+
+expected=$(cd "$TMP" && "$PATHFINDER" -3 -o true "$PROGRAM" main > /dev/null 2>&1 && grep -c "<not-all" main_ips.ffx)
+[ -n "$expected" ] || { echo "FAIL: single run of $PROGRAM"; exit 1; }
+
+"$PATHFINDER" -3 --server "$SOCKET" "$PROGRAM" main > "$TMP/log" 2>&1 &
+SERVER=$!
+for i in 1 2 3 4 5 6 7 8 9 10; do
+	[ -S "$SOCKET" ] && break
+	sleep 1
+done
+
+status=0
+for req in main main g main; do
+	reply=$(request "$req")
+	echo "$req: $reply"
+	case "$reply" in
+		ok*) ;;
+		*) status=1; continue ;;
+	esac
+	[ $req = main ] && [ "$(echo "$reply" | sed -n 's/.*ips=\([0-9]*\).*/\1/p')" != "$expected" ] && { echo "FAIL: expected ips=$expected"; status=1; }
+done
+request quit > /dev/null
+wait $SERVER || status=1
+[ $status = 0 ] && echo PASS || { echo FAIL; cat "$TMP/log"; }
+exit $status
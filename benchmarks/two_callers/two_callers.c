@@ -0,0 +1,24 @@
+// f is called from two sites of main and from g: its summary is shared by all its callers
+int f(int x)
+{
+	if(x > 10)
+		return x - 10;
+	return x;
+}
+
+int g(int y)
+{
+	int r = f(y);
+	if(r > 10) // infeasible: f never returns more than 10
+		r = 0;
+	return r;
+}
+
+int main(int argc)
+{
+	int a = f(argc);
+	int b = f(a + 1);
+	if(a > 10) // infeasible
+		b = 0;
+	return g(b);
+}
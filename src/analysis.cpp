@@ -27,6 +27,7 @@
 #include <ctime> // clock
 #include <iomanip> // std::setprecision
 #include <iostream> // std::cout
+#include <elm/sys/Thread.h>
 #include <elm/util/BitVector.h>
 #include <otawa/cfg/Edge.h>
 #include <otawa/cfg/features.h> // COLLECTED_CFG_FEATURE
@@ -37,14 +38,26 @@
 #include <sys/time.h>
 #include "analysis_states.h"
 #include "cfg_features.h"
+#include "ffx.h"
 #include "progress.h"
 #include "smt.h"
+#include "summary_cache.h"
+#include "telemetry.h"
+#include "trace.h"
 #include "dom/GlobalDominance.h"
 
 bool cfg_follow_calls = false; // for cfg_features.h
 Identifier<int> otawa::ANALYSIS_FLAGS("otawa::pathfinder::ANALYSIS_FLAGS", -1);
 Identifier<int> otawa::MERGE_THRESOLD("otawa::pathfinder::MERGE_THRESOLD", 0);
 Identifier<int> otawa::NB_CORES("otawa::pathfinder::NB_CORES", 0);
+Identifier<int> otawa::TRANSFER_CACHE_SIZE("otawa::pathfinder::TRANSFER_CACHE_SIZE", 0);
+Identifier<elm::String> otawa::SUMMARY_CACHE_PATH("otawa::pathfinder::SUMMARY_CACHE_PATH", "");
+Identifier<elm::String> otawa::RESULT_CACHE_PATH("otawa::pathfinder::RESULT_CACHE_PATH", "");
+Identifier<bool> otawa::RESIDENT_SUMMARIES("otawa::pathfinder::RESIDENT_SUMMARIES", false);
+Identifier<elm::String> otawa::FFX_STREAM_PATH("otawa::pathfinder::FFX_STREAM_PATH", "");
+Identifier<elm::String> otawa::SUMMARY_CHECKPOINT("otawa::pathfinder::SUMMARY_CHECKPOINT", "");
+Identifier<int> otawa::SUMMARY_CHECKPOINT_INTERVAL("otawa::pathfinder::SUMMARY_CHECKPOINT_INTERVAL", 300);
+Identifier<bool> otawa::RESUME_SUMMARIES("otawa::pathfinder::RESUME_SUMMARIES", false);
 
 Identifier<Vector<DetailedPath> > otawa::INFEASIBLE_PATHS("otawa::pathfinder::INFEASIBLE_PATHS", Vector<DetailedPath>()); // on a CFG
 
@@ -55,8 +68,9 @@ Identifier<Vector<DetailedPath> > otawa::INFEASIBLE_PATHS("otawa::pathfinder::IN
  * @attention There are three versions (-1, -2, -3). Only -3 is modular, -1 and -2 inline the CFG, and only -2 and -3 use SSA-like abstract interpretation. -1 is basically only predicates.
  */
 Analysis::Analysis()
+	: dag(NULL), gdom(NULL)
 #ifdef V1
-	: max_loop_depth(0)
+	, max_loop_depth(0)
 #endif
 	{ }
 
@@ -71,6 +85,14 @@ void Analysis::configure(const PropList &props)
 	flags = ANALYSIS_FLAGS(props);
 	state_size_limit = MERGE_THRESOLD(props);
 	nb_cores = NB_CORES(props);
+	transfer_cache_size = TRANSFER_CACHE_SIZE(props);
+	summary_cache_path = SUMMARY_CACHE_PATH(props);
+	result_cache_path = RESULT_CACHE_PATH(props);
+	resident_summaries = RESIDENT_SUMMARIES(props);
+	ffx_stream_path = FFX_STREAM_PATH(props);
+	summary_checkpoint = SUMMARY_CHECKPOINT(props);
+	summary_checkpoint_interval = SUMMARY_CHECKPOINT_INTERVAL(props);
+	resume_summaries = RESUME_SUMMARIES(props);
 
 	ASSERTP(flags != -1, "flags must be set!")
 	ASSERT(version() > 0)
@@ -100,12 +122,15 @@ void Analysis::processWorkSpace(WorkSpace *ws)
 #endif
 	*/
 	ASSERTP(INVOLVED_CFGS(ws) && INVOLVED_CFGS(ws)->count() > 0, "no CFGs found");
+	delete gdom; // the processor may be run several times (server mode)
 	gdom = new GlobalDominance(INVOLVED_CFGS(ws), GlobalDominance::EDGE_DOM | GlobalDominance::EDGE_POSTDOM); // no block dominance
 	context.dfa_state = dfa::INITIAL_STATE(ws); // initial state
 	context.sp = ws->platform()->getSP()->number(); // id of the stack pointer
 	context.max_tempvars = (short)ws->process()->maxTemp(); // maximum number of tempvars used
 	context.max_registers = (short)ws->platform()->regCount(); // count of registers
-	dag = new DAG(context.max_tempvars, context.max_registers);
+	if(!dag) // kept across runs, the resident summaries refer to it
+		dag = new DAG(context.max_tempvars, context.max_registers);
+	ip_stats = IPStats();
 	// vm will be initialized on CFG init
 
 	run(ws);
@@ -126,11 +151,31 @@ int Analysis::version(void) const
 
 /**
   * @fn const Vector<DetailedPath>& Analysis::run(const WorkSpace* ws);
-  * @brief Run the analysis on the main CFG
+  * @brief Run the analysis on the main CFG, or reuse the results of a previous identical run if a result cache is used
   */
 const Vector<DetailedPath>& Analysis::run(const WorkSpace* ws)
 {
-	return run(INVOLVED_CFGS(ws)->get(0));
+	CFG* entry = INVOLVED_CFGS(ws)->get(0);
+	if(result_cache_path.isEmpty())
+		return run(entry);
+
+	SummaryCache results(result_cache_path, ws, context, dag, flags, state_size_limit);
+	struct timeval tim;
+	gettimeofday(&tim, NULL);
+	const t::int64 t1 = tim.tv_sec*1000000+tim.tv_usec;
+	Vector<DetailedPath> ips;
+	if(results.loadResults(entry, ip_stats, ips))
+	{
+		DBGG("Reusing the results stored in " << result_cache_path)
+		infeasible_paths.init(entry);
+		infeasible_paths = ips;
+		gettimeofday(&tim, NULL);
+		printResults(0, (tim.tv_sec*1000000+tim.tv_usec-t1)/1000);
+		return infeasible_paths;
+	}
+	run(entry);
+	results.saveResults(entry, ip_stats, infeasible_paths);
+	return infeasible_paths;
 }
 
 /**
@@ -143,6 +188,14 @@ const Vector<DetailedPath>& Analysis::run(CFG *cfg)
 	DBG("Analysis V" << version())
 	DBG("Using SMT solver: " << (flags&DRY_RUN ? "(none)" : SMT::printChosenSolverInfo()))
 	DBG("Stack pointer identified to " << context.sp)
+	FFX ffx_stream;
+	if(!ffx_stream_path.isEmpty())
+	{
+		if(ffx_stream.open(cfg->name(), ffx_stream_path))
+			infeasible_paths.setStream(&ffx_stream);
+		else
+			cerr << "Could not stream the infeasible paths to " << ffx_stream_path << endl;
+	}
 
     struct timeval tim;
 	std::time_t start = clock();
@@ -150,14 +203,22 @@ const Vector<DetailedPath>& Analysis::run(CFG *cfg)
     gettimeofday(&tim, NULL);
     t::int64 t1 = tim.tv_sec*1000000+tim.tv_usec;
 	
-	processProg(cfg);
+	{
+		Telemetry::Phase phase("analysis");
+		processProg(cfg);
+	}
 
     gettimeofday(&tim, NULL);
     t::int64 t2 = tim.tv_sec*1000000+tim.tv_usec;
 	sw.stop();
 	std::time_t end = clock();
 	
+	infeasible_paths.setStream(NULL); // post-processing only reduces the streamed paths
+	telemetry.gauge("infeasible_paths_found", infeasible_paths.count());
 	postProcessResults(cfg);
+	telemetry.gauge("infeasible_paths", infeasible_paths.count());
+	telemetry.gauge("dag_operands", dag->operandCount());
+	telemetry.gauge("dag_predicates", dag->predicateCount());
 	printResults((end-start)*1000/CLOCKS_PER_SEC, (t2-t1)/1000);
 	if(flags&SHOW_PROGRESS) delete progress;
 	return infeasible_paths;
@@ -541,41 +602,113 @@ Option<Edge*> Analysis::f_postdom(GlobalDominance* gdom, Edge* e1, Edge* e2)
 	return elm::none;
 }
 
+// minimizes a contiguous range of infeasible paths, on its own thread
+class Analysis::DominanceJob : public elm::sys::Runnable
+{
+public:
+	DominanceJob(Vector<DetailedPath>& ips, int begin, int end, Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2), GlobalDominance* gdom)
+		: ips(ips), begin(begin), end(end), f(f), gdom(gdom), changed_count(0) { }
+	void run() {
+		for(int i = begin; i < end; i++)
+			if(simplifyUsingDominance(ips[i], f, gdom))
+				changed_count++;
+	}
+	inline int changedCount() const { return changed_count; }
+private:
+	Vector<DetailedPath>& ips;
+	int begin, end;
+	Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2);
+	GlobalDominance* gdom;
+	int changed_count;
+};
+
+/**
+ * @fn int Analysis::simplifyUsingDominance(Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2));
+ * @brief Minimize all infeasible paths with f, splitting them between threads when multithreaded.
+ * Each path is minimized independently and stays in place, so the result does not depend on the threads.
+ * @return the amount of infeasible paths that were changed
+ */
 int Analysis::simplifyUsingDominance(Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2))
 {
+	Vector<DetailedPath>& ips = infeasible_paths;
+	const int n = ips.count();
 	int changed_count = 0;
-	for(Vector<DetailedPath>::Iter dpiter(infeasible_paths); dpiter; dpiter++)
+	if(multithreaded() && n >= nb_cores)
 	{
-		DetailedPath& dp = infeasible_paths.get(dpiter);
-		DBG(dp << "...")
-		bool hasChanged = false, changed = false;
-		do
+		gdom->computeAll(); // the lazy computations are not thread-safe
+		Vector<elm::sys::Thread*> threads(nb_cores);
+		Vector<DominanceJob*> jobs(nb_cores);
+		for(int tid = 0; tid < nb_cores; tid++)
+		{
+			jobs.push(new DominanceJob(ips, n * tid / nb_cores, n * (tid+1) / nb_cores, f, gdom));
+			threads.push(elm::sys::Thread::make(*jobs[tid]));
+		}
+		for(int tid = 0; tid < nb_cores; tid++)
+			threads[tid]->start();
+		for(int tid = 0; tid < nb_cores; tid++)
 		{
-			changed = false;
-			elm::Option<DetailedPath::FlowInfo> prev = elm::none;
-			for(DetailedPath::Iterator i(dp); i; i++)
+			threads[tid]->join();
+			changed_count += jobs[tid]->changedCount();
+			delete jobs[tid];
+			delete threads[tid];
+		}
+	}
+	else
+		for(int i = 0; i < n; i++)
+			if(simplifyUsingDominance(ips[i], f, gdom))
+				changed_count++;
+	infeasible_paths.reindex();
+	return changed_count;
+}
+
+/**
+ * @fn bool Analysis::simplifyUsingDominance(DetailedPath& dp, Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2), GlobalDominance* gdom);
+ * @brief Remove the edges of an infeasible path that f finds redundant with an adjacent edge
+ * @return true if the path was changed
+ */
+bool Analysis::simplifyUsingDominance(DetailedPath& dp, Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2), GlobalDominance* gdom)
+{
+	DBG(dp << "...")
+	// a removal only makes one new pair of adjacent edges, so a single pass with a stack of the kept edges is enough
+	Vector<DetailedPath::FlowInfo> items;
+	for(DetailedPath::Iterator i(dp); i; i++)
+		items.push(*i);
+	BitVector keep(items.length(), true);
+	Vector<int> kept; // indices of the edges kept so far
+	bool hasChanged = false;
+	for(int k = 0; k < items.length(); k++)
+	{
+		if(!items[k].isEdge())
+			continue;
+		Edge* e = items[k].getEdge();
+		bool removed = false;
+		while(kept)
+		{
+			Option<Edge*> edge_to_remove = f(gdom, items[kept.top()].getEdge(), e);
+			if(!edge_to_remove)
+				break;
+			hasChanged = true;
+			if(*edge_to_remove == e)
 			{
-				if(i->isEdge())
-				{
-					if(prev)
-						if(Option<Edge*> edge_to_remove = f(gdom, (*prev).getEdge(), i->getEdge()))
-						{
-							dp.remove(edge_to_remove); // search and destroy
-							changed = true;
-							hasChanged = true;
-							break;
-						}
-					prev = elm::some(*i);
-				}
+				removed = true;
+				break;
 			}
-		} while(changed);
-		if(hasChanged) {
-			dp.removeCallsAtEndOfPath();
-			DBG("\t...to " << dp)
-			changed_count++;
+			keep.set(kept.pop(), false);
 		}
+		if(removed)
+			keep.set(k, false);
+		else
+			kept.push(k);
 	}
-	return changed_count;
+	if(hasChanged) {
+		dp.clear();
+		for(int k = 0; k < items.length(); k++)
+			if(keep.bit(k))
+				dp.addLast(items[k]);
+		dp.removeCallsAtEndOfPath();
+		DBG("\t...to " << dp)
+	}
+	return hasChanged;
 }
 
 /**
@@ -588,15 +721,24 @@ int Analysis::removeDuplicateIPs()
 	const int n = infeasible_paths.count();
 	if(!n) // no infeasible paths
 		return 0;
+	// keep the last occurrence of each path: scan backwards, comparing only paths of the same hash
 	BitVector bv(n, true);
-	for(int i = 0; i < n; i++)
-		for(int j = i+1; j < n; j++)
+	elm::avl::Map<elm::t::hash, int> last; // hash -> kept path with this hash, the one with the smallest index so far
+	Vector<int> same_hash(n);
+	for(int i = n-1; i >= 0; i--)
+	{
+		const elm::t::hash h = infeasible_paths[i].hash();
+		const int first = last.get(h, -1);
+		for(int j = first; j >= 0; j = same_hash[n-1-j])
 			if(infeasible_paths[j] == infeasible_paths[i]) // found a duplicate
 			{
 				bv.set(i, false); // do not include i
-				// ASSERTP(false, "it seems like we never hit this point?? rm assert if we do, this should be the case")
 				break; // do not look any further
 			}
+		same_hash.push(first);
+		if(bv[i])
+			last.put(h, i);
+	}
 	const int k = bv.countBits();
 	Vector<DetailedPath> v(bv.countBits()); // the new infeasible paths vector will have the perfect size
 	for(int i = 0; i < n; i++)
@@ -607,6 +749,136 @@ int Analysis::removeDuplicateIPs()
 	return k - n;
 }
 
+// edges of an infeasible path, numbered, with a 64-bit signature of the set of edges
+class Analysis::SubsumptionInfo
+{
+public:
+	Vector<int> edges; // in order
+	Vector<DetailedPath::FlowInfo> context; // the other flow info, in order
+	t::uint64 sig;
+	int rarest; // edge of the path contained in the fewest paths
+
+	inline bool sameContext(const SubsumptionInfo& si, const DetailedPath& p1, const DetailedPath& p2) const {
+		if(p1.function() != p2.function() || context.length() != si.context.length())
+			return false;
+		for(int i = 0; i < context.length(); i++)
+			if(context[i] != si.context[i])
+				return false;
+		return true;
+	}
+	// the edges of this are an ordered subsequence of the ones of si
+	inline bool includedIn(const SubsumptionInfo& si) const {
+		if((sig & ~si.sig) != 0) // some edge of this is not in si
+			return false;
+		int k = 0;
+		for(int i = 0; i < si.edges.length() && k < edges.length(); i++)
+			if(si.edges[i] == edges[k])
+				k++;
+		return k == edges.length();
+	}
+};
+
+/**
+ * @fn int Analysis::removeSubsumedIPs(void);
+ * @brief Remove the infeasible paths that contain another infeasible path: its edges in the same order, in the same function and context.
+ * Paths are processed by increasing length, and each kept path is indexed by its rarest edge,
+ * so a path is only compared to the shorter paths that share an edge with it, first through a bit signature.
+ * @return the amount of infeasible paths that were removed
+ */
+int Analysis::removeSubsumedIPs()
+{
+	const int n = infeasible_paths.count();
+	if(!n)
+		return 0;
+	SubsumptionInfo* info = new SubsumptionInfo[n];
+	elm::avl::Map<Edge*, int> ids;
+	Vector<int> frequency; // amount of paths using an edge
+	int max_length = 0;
+	for(int i = 0; i < n; i++)
+	{
+		for(DetailedPath::Iterator fi(infeasible_paths[i]); fi; fi++)
+		{
+			if(!fi->isEdge())
+			{
+				info[i].context.push(*fi);
+				continue;
+			}
+			int id = ids.get(fi->getEdge(), -1);
+			if(id < 0)
+			{
+				ids.put(fi->getEdge(), id = frequency.length());
+				frequency.push(0);
+			}
+			frequency[id]++;
+			info[i].edges.push(id);
+		}
+		if(info[i].edges.length() > max_length)
+			max_length = info[i].edges.length();
+	}
+	for(int i = 0; i < n; i++)
+	{
+		info[i].sig = 0;
+		info[i].rarest = -1;
+		for(int k = 0; k < info[i].edges.length(); k++)
+		{
+			const int e = info[i].edges[k];
+			info[i].sig |= t::uint64(1) << (e % 64);
+			if(info[i].rarest < 0 || frequency[e] < frequency[info[i].rarest])
+				info[i].rarest = e;
+		}
+	}
+
+	// order paths by length (counting sort, stable)
+	Vector<int> start(max_length+2);
+	for(int l = 0; l < max_length+2; l++)
+		start.push(0);
+	for(int i = 0; i < n; i++)
+		start[info[i].edges.length()+1]++;
+	for(int l = 0; l < max_length+1; l++)
+		start[l+1] += start[l];
+	int* order = new int[n];
+	for(int i = 0; i < n; i++)
+		order[start[info[i].edges.length()]++] = i;
+
+	BitVector keep(n, true);
+	Vector<int>* index = new Vector<int>[frequency.length()]; // rarest edge -> kept paths
+	for(int o = 0; o < n; o++)
+	{
+		const int i = order[o];
+		const SubsumptionInfo& b = info[i];
+		for(int k = 0; k < b.edges.length() && keep[i]; k++)
+		{
+			const Vector<int>& candidates = index[b.edges[k]];
+			for(int c = 0; c < candidates.length(); c++)
+			{
+				const int j = candidates[c];
+				if(info[j].includedIn(b) && info[j].sameContext(b, infeasible_paths[j], infeasible_paths[i]))
+				{
+					DBG("\t" << infeasible_paths[i] << " contains " << infeasible_paths[j])
+					keep.set(i, false);
+					break;
+				}
+			}
+		}
+		if(keep[i] && b.rarest >= 0)
+			index[b.rarest].push(i);
+	}
+	delete[] index;
+	delete[] order;
+	delete[] info;
+
+	const int k = keep.countBits();
+	if(k != n)
+	{
+		Vector<DetailedPath> v(k);
+		for(int i = 0; i < n; i++)
+			if(keep[i])
+				v.push(infeasible_paths[i]);
+		infeasible_paths = v;
+	}
+	return n - k;
+}
+
 /**
  * @fn void Analysis::postProcessResults(CFG *cfg);
  * @brief      Posts processes results by removing useless infeasible paths or edges within infeasible paths.
@@ -617,6 +889,7 @@ void Analysis::postProcessResults(CFG *cfg)
 	if(! (flags&POST_PROCESSING))
 		return;
 	DBG(color::On_IGre() << "post-processing..." << color::RCol())
+	Trace::Span span("post", "post-processing");
 	// elm::log::Debug::setDebugFlag(true);
 	// elm::log::Debug::setVerboseLevel(1);
 	/*otawa::Edge* program_entry_edge = theOnly(cfg->entry()->outs());
@@ -626,12 +899,28 @@ void Analysis::postProcessResults(CFG *cfg)
 		if(dp.contains(program_entry_edge))
 			dp.remove(program_entry_edge);
 	}*/ // should be removed by dominance anyway
-	int count = simplifyUsingDominance(&f_dom);
-	DBGG("Dominance: minimized " << count << " infeasible paths.")
-	count = simplifyUsingDominance(&f_postdom);
-	DBGG("Post-dominance: minimized " << count << " infeasible paths.")
-	count = removeDuplicateIPs();
-	DBGG("Removed " << count << " duplicate infeasible paths.")
+	int count;
+	{
+		Telemetry::Phase phase("dominance");
+		count = simplifyUsingDominance(&f_dom);
+		DBGG("Dominance: minimized " << count << " infeasible paths.")
+	}
+	{
+		Telemetry::Phase phase("post-dominance");
+		count = simplifyUsingDominance(&f_postdom);
+		DBGG("Post-dominance: minimized " << count << " infeasible paths.")
+	}
+	{
+		Telemetry::Phase phase("remove duplicates");
+		count = removeDuplicateIPs();
+		DBGG("Removed " << count << " duplicate infeasible paths.")
+	}
+	if(flags&REMOVE_SUBSUMED)
+	{
+		Telemetry::Phase phase("remove subsumed");
+		count = removeSubsumedIPs();
+		DBGG("Removed " << count << " subsumed infeasible paths.")
+	}
 }
 
 /**
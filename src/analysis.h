@@ -32,6 +32,7 @@
 // #define V1 // v1 support (slows down v2 and v3)
 
 // #include <elm/genstruct/SLList.h>
+#include <elm/avl/Map.h>
 #include <otawa/cfg/Edge.h>
 #include <otawa/cfg/features.h>
 #include <otawa/dfa/State.h>
@@ -48,6 +49,8 @@
 using namespace otawa;
 using elm::genstruct::SLList;
 
+class FFX;
+
 class Analysis {
 public:
 	typedef SLList<Edge*> OrderedPath;
@@ -55,6 +58,8 @@ public:
 	class State; // Abstract state corresponding to a set of paths at one point of the program
 	class States; // Collection of State representing an abstract state at one point of the program
 	class SPEquals;
+	class CFGSnapshot; // Flattened view of a CFG for the fixpoint loop
+	class SummaryCache; // On-disk store of function summaries (v3)
 	// static Identifier<int> ANALYSIS_FLAGS, NB_CORES, MERGE_THRESOLD;
 
 	enum // flags
@@ -71,12 +76,15 @@ public:
 		ALLOW_NONLINEAR_OPRS = 1 << 10,
 		SHOW_PROGRESS		 = 1 << 11,
 		POST_PROCESSING		 = 1 << 12,
+		WTO_ITERATION		 = 1 << 13,
+		LIVENESS_PRUNING	 = 1 << 14,
 		SP_CRITICAL			 = 1 << 15,
 		CLEAN_TOPS			 = 1 << 16,
 		ASSUME_IDENTICAL_SP	 = 1 << 17,
 		NO_WIDENING			 = 1 << 18,
 		UNMINIMIZED_PATHS	 = 1 << 19,
 		CLAMP_PREDICATE_SIZE = 1 << 20,
+		REMOVE_SUBSUMED		 = 1 << 21,
 	};
 protected:
 	typedef struct
@@ -94,14 +102,17 @@ protected:
 		LEAVE,
 	} loopheader_status_t; // Fixpoint status of the loop header, for annotation
 
-	// just a reference on the INFEASIBLE_PATHS identifier
+	// just a reference on the INFEASIBLE_PATHS identifier, with an index of the paths by hash
 	class InfeasiblePaths {
 	public:
-		InfeasiblePaths() : ips(NULL) { }
-		inline void init(CFG* cfg) { INFEASIBLE_PATHS(cfg) = Vector<DetailedPath>(); ips = &INFEASIBLE_PATHS.ref(cfg); }
+		InfeasiblePaths() : ips(NULL), stream(NULL) { }
+		inline void init(CFG* cfg) { INFEASIBLE_PATHS(cfg) = Vector<DetailedPath>(); ips = &INFEASIBLE_PATHS.ref(cfg); reindex(); }
 		inline operator const Vector<DetailedPath>&() const { return *ips; }
-		inline operator Vector<DetailedPath>&() { return *ips; }
-		inline InfeasiblePaths& operator=(const Vector<DetailedPath>& x) { *ips = x; return *this; }
+		inline operator Vector<DetailedPath>&() { return *ips; } // call reindex() after modifying paths through this
+		inline InfeasiblePaths& operator=(const Vector<DetailedPath>& x) { *ips = x; reindex(); return *this; }
+		bool add(const DetailedPath& ip);
+		void reindex();
+		inline void setStream(FFX* s) { stream = s; } // also write the new paths there as they are added
 
 		// Vector methods
 		inline int count(void) const { return ips->count(); }
@@ -109,6 +120,9 @@ protected:
 		inline const DetailedPath& operator[](int i) const { return (*ips)[i]; }
 	private:
 		Vector<DetailedPath>* ips;
+		elm::avl::Map<elm::t::hash, int> index; // hash -> last path added with this hash
+		Vector<int> same_hash; // previous path with the same hash, -1 if none
+		FFX* stream;
 	};
 
 	class IPStats {
@@ -158,6 +172,14 @@ protected:
 	Analysis::Progress* progress;
 	InfeasiblePaths infeasible_paths;
 	int state_size_limit, nb_cores, flags; // read by inherited class
+	int transfer_cache_size; // v3
+	elm::String summary_cache_path; // v3
+	elm::String result_cache_path;
+	bool resident_summaries; // v3, keep the summaries in memory across runs
+	elm::String ffx_stream_path;
+	elm::String summary_checkpoint; // v3
+	int summary_checkpoint_interval; // v3, in seconds
+	bool resume_summaries; // v3, load the summaries of the checkpoint first
 
 	static Identifier<LockPtr<Analysis::States> > EDGE_S; // Trace on an edge
 	static Identifier<Analysis::State>			  LH_S; // Trace on a loop header
@@ -176,7 +198,7 @@ private:
 	virtual LockPtr<States> merge(LockPtr<States> v, Block* b) const = 0;
 
 	virtual bool inD_ip(const otawa::Edge* e) const = 0;
-	virtual IPStats ipcheck(States& s, Vector<DetailedPath>& infeasible_paths) const = 0;
+	virtual IPStats ipcheck(States& s, InfeasiblePaths& infeasible_paths) const = 0;
 
 protected:
 	inline static loopheader_status_t loopStatus(const Block* h) { ASSERT(LOOP_HEADER(h)); return LH_STATUS.get(h,ENTER); }
@@ -219,10 +241,11 @@ protected:
 	virtual void processCFG(CFG* cfg, bool use_initial_data) = 0;
 	virtual void I(Block* b, LockPtr<Analysis::States> s) = 0; // modifies existing states
 	LockPtr<States> I(const Vector<Edge*>::Iter& e, LockPtr<States> s); // creates new states
+	LockPtr<States> I(Edge* e, LockPtr<States> s, bool copy);
 	static void onAnyInfeasiblePath();
 	static bool checkInfeasiblePathValidity(const Vector<State>& sv, const Vector<Option<Path*> >& sv_paths, /*const Edge* e,*/ const Path& infeasible_path, elm::String& counterexample);
 	static DetailedPath reorderInfeasiblePath(const Path& infeasible_path, const DetailedPath& full_path);
-	static void addDetailedInfeasiblePath(const DetailedPath& infeasible_path, Vector<DetailedPath>& infeasible_paths);
+	static void addDetailedInfeasiblePath(const DetailedPath& infeasible_path, InfeasiblePaths& infeasible_paths);
 	static bool isSubPath(const OrderedPath& included_path, const Path& path_set);
 
 	bool anyEdgeHasTrace(const Vector<Edge*>& edges) const;
@@ -249,8 +272,12 @@ private:
 	// dominance stuff
 	static Option<Edge*> f_dom(GlobalDominance* gdom, Edge* e1, Edge* e2);
 	static Option<Edge*> f_postdom(GlobalDominance* gdom, Edge* e1, Edge* e2);
+	class DominanceJob;
 	int simplifyUsingDominance(Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2));
+	static bool simplifyUsingDominance(DetailedPath& dp, Option<Edge*> (*f)(GlobalDominance* gdom, Edge* e1, Edge* e2), GlobalDominance* gdom);
 	int removeDuplicateIPs(void);
+	class SubsumptionInfo;
+	int removeSubsumedIPs(void);
 
 	// bool invalidate_constant_info
 	enum {
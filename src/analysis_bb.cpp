@@ -31,10 +31,14 @@
 #include "struct/operand.h"
 #include "debug.h"
 #include "analysis_state.h"
+#include "compiled_bb.h"
 #include "v2/analysis_sem2.h"
 
 using namespace otawa::sem;
 
+// The invalidate/replace/update scans below test Operand::footprint() before traversing a predicate.
+// This is a constant-factor filter, not an index: each instruction still visits every predicate of the state.
+
 /**
  * @brief      Process a BasicBlock
  *
@@ -44,35 +48,34 @@ using namespace otawa::sem;
  */
 void Analysis::State::processBB(const BasicBlock *bb, VarMaker& vm, int flags)
 {
+	invalidateFingerprint();
 	DBG("Processing " << (otawa::Block*)bb << " (" << bb->address() << ") of path " << dumpPath())
 	SLList<LabelledPredicate> generated_preds_before_condition;
 	generated_preds.clear();
 	generated_preds_taken.clear();
 	
-	short inst_id = 0;
 	// parse assembly instructions
-	for(BasicBlock::InstIter insts(bb); insts; insts++, inst_id++)
+	const CompiledBB& code = CompiledBB::of(bb);
+	for(short inst_id = 0; inst_id < code.countInsts(); inst_id++)
 	{
-		//DBG(color::BIPur() << *insts)
-		DBG(color::Pur() << *insts)
-		sem::Block block;
-		insts->semInsts(block);
+		//DBG(color::BIPur() << *code.inst(inst_id))
+		DBG(color::Pur() << *code.inst(inst_id))
 		
 		sem::inst last_condition(NOP);
-		PathIter seminsts;
 		SemanticParser semp(*this, vm);
 		// parse semantical instructions
-		for(seminsts.start(*insts); seminsts; seminsts++)
+		for(int k = code.firstStep(inst_id); k < code.endStep(inst_id); k++)
 		{
-			DBG(color::IPur() << *seminsts)
+			const CompiledBB::Step& step = code.step(k);
+			DBG(color::IPur() << step.inst)
 			
-			if(seminsts.isCond()) // IF
+			if(step.isCond()) // IF
 			{	// backup the list of generated predicates before entering the condition
 				generated_preds_before_condition.addAll(generated_preds); // side effect: reverses the order of the list
 				DBG(color::IBlu() << "(Parsing taken path)")
-				last_condition = *seminsts; // save this for later
+				last_condition = step.inst; // save this for later
 			}
-			if(seminsts.pathEnd()) // CONT
+			if(step.pathEnd()) // CONT
 			{ 	// dumping the current generated_preds into the previous_paths_preds list
 				invalidateTempVars(); // do the end-of-instruction tempvar invalidation first
 				DBG(color::IBlu() << "(Parsing not taken path)")
@@ -80,8 +83,8 @@ void Analysis::State::processBB(const BasicBlock *bb, VarMaker& vm, int flags)
 				generated_preds = generated_preds_before_condition;
 			}
 			if((flags & VERSION) == 1)
-				processSemInst1(seminsts, last_condition);
-			else if(semp.process(seminsts) != 0)
+				processSemInst1(step.inst, last_condition);
+			else if(semp.process(step.inst, step.isCond()) != 0)
 			{
 				wipeMemory(vm);
 				setMemoryInitPoint(bb, inst_id);
@@ -157,10 +160,11 @@ bool Analysis::State::tryToKeepVar(const OperandVar& var)//, const Predicate*& r
 {
 	// removed_predicate = NULL;
 	// try and identify a value for ?3 (look for a ?3 = X predicate)
+	const Operand::footprint_t f = var.footprint();
 	for(PredIterator piter(*this); piter; piter++)
 	{
 		const Predicate &p = piter.pred();
-		if(p.opr() == CONDOPR_EQ)
+		if(p.opr() == CONDOPR_EQ && p.mayInvolve(f))
 		{
 			const int left_involves_var = p.leftOperand().involvesVariable(var);
 			const int right_involves_var = p.rightOperand().involvesVariable(var);
@@ -200,9 +204,10 @@ bool Analysis::State::invalidateVar(const OperandVar& var, bool invalidate_const
 	bool rtn = tryToKeepVar(var);//, removed_predicate);
 	if(!rtn) // no X expression has been found to match ?3 = X, thus we have to remove every occurrence of ?3
 	{
+		const Operand::footprint_t f = var.footprint();
 		for(PredIterator piter(*this); piter; )
 		{
-			if(piter.pred().involvesVariable(var))
+			if(piter.pred().mayInvolve(f) && piter.pred().involvesVariable(var))
 			{
 				DBG(color::IPur() << DBG_SEPARATOR << color::IYel() << " - " << *piter)
 				removePredicate(piter);
@@ -244,9 +249,10 @@ bool Analysis::State::invalidateMem(const OperandMem& addr)
 	if(Option<Constant> maybe_val = findConstantValueOfMemCell(addr, labels))
 		return replaceMem(addr, dag->cst(*maybe_val), labels); // try to keep the info
 	bool rtn = false;
+	const Operand::footprint_t f = addr.footprint();
 	for(PredIterator piter(*this); piter; )
 	{
-		if(piter.pred().involvesMemoryCell(addr))
+		if(piter.pred().mayInvolve(f) && piter.pred().involvesMemoryCell(addr))
 		{
 			DBG(color::IPur() << DBG_SEPARATOR << color::IYel() << " - " << *piter)
 			removePredicate(piter);
@@ -274,7 +280,7 @@ bool Analysis::State::invalidateTempVars()
 		loop = false;
 		for(SLList<LabelledPredicate>::Iterator iter(generated_preds); iter; iter++)
 		{
-			if(iter->pred().countTempVars())
+			if(iter->pred().mayInvolve(Operand::FOOTPRINT_TEMPVARS) && iter->pred().countTempVars())
 			{
 				OperandVar temp_var(0);
 				Operand const* expr = NULL;
@@ -295,7 +301,7 @@ bool Analysis::State::invalidateTempVars()
 	// Second step: remove everything that is left and still contains a tempvar
 	for(SLList<LabelledPredicate>::Iterator iter(generated_preds); iter; )
 	{
-		if(iter->pred().countTempVars())
+		if(iter->pred().mayInvolve(Operand::FOOTPRINT_TEMPVARS) && iter->pred().countTempVars())
 		{	// remove the predicate
 			DBG(color::IYel() << "- " << iter->pred())
 			generated_preds.remove(iter);
@@ -308,13 +314,14 @@ bool Analysis::State::invalidateTempVars()
 
 int Analysis::State::invalidateStackBelow(const Constant& stack_limit)
 {
+	invalidateFingerprint();
 	int count = 0;
 	ASSERT(stack_limit.isRelative());
 	// do not try to replace everything unlike invalidateTempVars - the point is to get rid of useless obsolete data
 	// wait what... no we sometimes have A = B and B >= 5, gotta keep A >= 5 if B is irrelevant
 	for(PredIterator piter(*this); piter; piter++) //)
 	{
-		if(piter.pred().involvesStackBelow(stack_limit))
+		if(piter.pred().mayInvolve(Operand::FOOTPRINT_MEMORY) && piter.pred().involvesStackBelow(stack_limit))
 		// while(const Option<Constant>& addr_involved = piter.pred().involvesStackBelow(stack_limit))
 		{
 			removePredicate(piter);
@@ -382,9 +389,10 @@ int Analysis::State::invalidateStackBelow(const Constant& stack_limit)
 bool Analysis::State::replaceVar(const OperandVar& var, const Operand* expr)
 {
 	bool rtn = false;
+	const Operand::footprint_t f = var.footprint();
 	for(PredIterator piter(*this); piter; )
 	{
-		if(piter.pred().involvesVariable(var))
+		if(piter.pred().mayInvolve(f) && piter.pred().involvesVariable(var))
 		{
 			Predicate p = piter.pred();
 			String prev_str = _ << piter.pred();
@@ -447,9 +455,10 @@ bool Analysis::State::replaceVar(const OperandVar& var, const Operand* expr)
 bool Analysis::State::replaceTempVar(const OperandVar& temp_var, const Operand* expr)
 {
 	bool rtn = false;
+	const Operand::footprint_t f = temp_var.footprint();
 	for(SLList<LabelledPredicate>::Iterator iter(generated_preds); iter; iter++)
 	{
-		if(iter->pred().involvesVariable(temp_var))
+		if(iter->pred().mayInvolve(f) && iter->pred().involvesVariable(temp_var))
 		{
 			Predicate p(iter->pred());
 			String prev_str = _ << p;			
@@ -478,8 +487,14 @@ bool Analysis::State::replaceMem(const OperandMem& opdm, const Operand* expr, co
 {
 	bool rtn = false;
 	elm::String prev_str;
+	const Operand::footprint_t f = opdm.footprint();
 	for(SLList<LabelledPredicate>::MutableIterator iter(generated_preds); iter; )
 	{
+		if(!iter.item().pred().mayInvolve(f))
+		{
+			iter++;
+			continue;
+		}
 		if(dbg_verbose == DBG_VERBOSE_ALL)
 			prev_str = _ << iter.item().pred();
 		if(iter.item().updatePred(*dag, dag->mem(opdm), expr))
@@ -507,6 +522,11 @@ bool Analysis::State::replaceMem(const OperandMem& opdm, const Operand* expr, co
 	}
 	for(SLList<LabelledPredicate>::MutableIterator iter(labelled_preds); iter; )
 	{
+		if(!iter.item().pred().mayInvolve(f))
+		{
+			iter++;
+			continue;
+		}
 		if(dbg_verbose == DBG_VERBOSE_ALL)
 			prev_str = _ << iter.item();
 		if(iter.item().updatePred(*dag, dag->mem(opdm), expr))
@@ -557,9 +577,10 @@ bool Analysis::State::update(const OperandVar& opd_to_update, const Operand* opd
 #	endif
 	
 	bool rtn = false;
+	const Operand::footprint_t f = opd_to_update.footprint();
 	for(PredIterator piter(*this); piter; piter++)
 	{
-		if(piter.pred().involvesOperand(opd_to_update))
+		if(piter.pred().mayInvolve(f) && piter.pred().involvesOperand(opd_to_update))
 		{
 			DBG(color::IPur() << DBG_SEPARATOR << color::Blu() << " " DBG_SEPARATOR << color::Cya() << " - " << *piter)
 			
@@ -587,7 +608,7 @@ bool Analysis::State::invalidateAllMemory()
 	bool rtn = false;
 	for(PredIterator piter(*this); piter; )
 	{
-		if(piter.pred().involvesMemory())
+		if(piter.pred().mayInvolve(Operand::FOOTPRINT_MEMORY) && piter.pred().involvesMemory())
 		{
 			DBG(color::IPur() << DBG_SEPARATOR << color::IYel() << " - " << *piter)
 			removePredicate(piter);
@@ -36,6 +36,7 @@
 #include <otawa/cfg/Edge.h>
 #include "analysis_states.h"
 #include "cfg_features.h"
+#include "ffx.h"
 
 using namespace elm::io;
 
@@ -68,7 +69,16 @@ void Analysis::processProg(CFG* cfg)
  */
 LockPtr<Analysis::States> Analysis::I(const Vector<Edge*>::Iter& e, LockPtr<States> s)
 {
-	if(! e.ended()) // more edges to come
+	return I(*e, s, !e.ended()); // more edges to come
+}
+
+/**
+ * @brief      Interpretation function of an Edge.
+ * @param copy Work on a copy of the provided states
+ */
+LockPtr<Analysis::States> Analysis::I(Edge* e, LockPtr<States> s, bool copy)
+{
+	if(copy)
 		s = LockPtr<States>(new States(*s));
 	if(s->isEmpty())
 		DBGG("-\tpropagating bottom state")
@@ -152,10 +162,20 @@ bool Analysis::checkInfeasiblePathValidity(const Vector<Analysis::State>& sv, co
 	for(Vector<Analysis::State>::Iter si(sv); si; si++, pi++) // iterate through paths at the same time
 	{
 		// if feasible path && contained in the minimized inf. path
-		if((*pi).isNone() && isSubPath(si->getDetailedPath().toOrderedPath(), infeasible_path))
+		if((*pi).isNone())
 		{
-			counterexample = si->dumpPath();
-			return false;
+			if(isSubPath(si->getDetailedPath().toOrderedPath(), infeasible_path))
+			{
+				counterexample = si->dumpPath();
+				return false;
+			}
+			// the paths of collapsed states are feasible as well
+			for(SLList<DetailedPath>::Iterator ai(si->getAliasPaths()); ai; ai++)
+				if(isSubPath(ai->toOrderedPath(), infeasible_path))
+				{
+					counterexample = _ << *ai;
+					return false;
+				}
 		}
 	}
 	return true;
@@ -195,7 +215,7 @@ DetailedPath Analysis::reorderInfeasiblePath(const Path& ip, const DetailedPath&
  * @param[in]  ip                The infeasible path to add
  * @param      infeasible_paths  The collection of paths to add to
  */
-void Analysis::addDetailedInfeasiblePath(const DetailedPath& ip, Vector<DetailedPath>& infeasible_paths)
+void Analysis::addDetailedInfeasiblePath(const DetailedPath& ip, InfeasiblePaths& infeasible_paths)
 {
 	DetailedPath new_ip(ip);
 	ASSERT(ip.hasAnEdge());
@@ -203,12 +223,46 @@ void Analysis::addDetailedInfeasiblePath(const DetailedPath& ip, Vector<Detailed
 	// Block *b = ip.firstEdge()->source();
 	// for(LoopHeaderIter i(b); i; i++)
 	// 	new_ip.addEnclosingLoop(*i);
-	if(! infeasible_paths.contains(new_ip))
-		infeasible_paths.add(new_ip);
-	else
+	if(! infeasible_paths.add(new_ip))
 		DBG("not adding redundant IP: " << new_ip)
 }
 
+/**
+ * @fn bool Analysis::InfeasiblePaths::add(const DetailedPath& ip);
+ * @brief Add an infeasible path, unless it is already there. Only paths of the same hash are compared
+ * @return true if the path was added
+ */
+bool Analysis::InfeasiblePaths::add(const DetailedPath& ip)
+{
+	const elm::t::hash h = ip.hash();
+	const int last = index.get(h, -1);
+	for(int i = last; i >= 0; i = same_hash[i])
+		if((*ips)[i] == ip)
+			return false;
+	index.put(h, ips->count());
+	same_hash.push(last);
+	ips->add(ip);
+	if(stream)
+		stream->stream(ip);
+	return true;
+}
+
+/**
+ * @fn void Analysis::InfeasiblePaths::reindex();
+ * @brief Rebuild the hash index, after the paths were modified
+ */
+void Analysis::InfeasiblePaths::reindex()
+{
+	index.clear();
+	same_hash.clear();
+	for(int i = 0; i < ips->count(); i++)
+	{
+		const elm::t::hash h = (*ips)[i].hash();
+		same_hash.push(index.get(h, -1));
+		index.put(h, i);
+	}
+}
+
 /**
  * @fn static void Analysis::onAnyInfeasiblePath();
  * @brief Debugs to do when detecting any infeasible path
@@ -41,6 +41,7 @@ Analysis::State::State(bool bottom) : context(NULL), dag(NULL), lvars(), mem(53)
 #ifdef V1
 	, constants()
 #endif
+	, fp(0), fp_vars(0), fp_valid(false)
 	{ }
 
 Analysis::State::State(Edge* entry_edge, const context_t& context_, DAG* dag, bool init)
@@ -49,6 +50,7 @@ Analysis::State::State(Edge* entry_edge, const context_t& context_, DAG* dag, bo
 #ifdef V1
 	, constants(context->max_tempvars, context->max_registers)
 #endif
+	, fp(0), fp_vars(0), fp_valid(false)
 {
 	generated_preds.clear(); // generated_preds := [[]]
 	labelled_preds.clear(); // labelled_preds := [[]]
@@ -68,12 +70,16 @@ Analysis::State::State(const State& s)
 	constants(s.constants),
 #endif
 	  labelled_preds(s.labelled_preds), generated_preds(s.generated_preds), generated_preds_taken(s.generated_preds_taken)//, fixpoint(s.fixpoint)
+	, alias_paths(s.alias_paths), fp(s.fp), fp_vars(s.fp_vars), fp_valid(s.fp_valid)
 	{ }
 
 void Analysis::State::appendEdge(Edge* e)
 {
+	invalidateFingerprint();
 	// add edge to the end of the path
 	this->path.addLast(e);
+	for(SLList<DetailedPath>::MutableIterator i(alias_paths); i; i++)
+		i.item().addLast(e);
 	// we now need to label the correct list of predicates
 	SLList<LabelledPredicate> &relevant_preds = (isConditional(e->source()) && e->isTaken())
 		? generated_preds_taken // conditional TAKEN
@@ -87,10 +93,39 @@ void Analysis::State::appendEdge(Edge* e)
 	lvars.onEdge(e);
 }
 
+void Analysis::State::onLoopExit(Option<Block*> maybe_loop_header)
+{
+	path.onLoopExit(maybe_loop_header);
+	for(SLList<DetailedPath>::MutableIterator i(alias_paths); i; i++)
+		i.item().onLoopExit(maybe_loop_header);
+}
+
+void Analysis::State::onCall(SynthBlock* sb)
+{
+	path.onCall(sb);
+	for(SLList<DetailedPath>::MutableIterator i(alias_paths); i; i++)
+		i.item().onCall(sb);
+}
+
+void Analysis::State::onReturn(SynthBlock* sb)
+{
+	path.onReturn(sb);
+	for(SLList<DetailedPath>::MutableIterator i(alias_paths); i; i++)
+		i.item().onReturn(sb);
+}
+
+void Analysis::State::clearPath()
+{
+	path.clear();
+	for(SLList<DetailedPath>::MutableIterator i(alias_paths); i; i++)
+		i.item().clear();
+}
+
 
 // PredIterator
 void Analysis::State::setPredicate(PredIterator &iter, const LabelledPredicate &labelled_predicate)
 {
+	invalidateFingerprint();
 	ASSERT(!iter.ended());
 	if(iter.state == PredIterator::GENERATED_PREDS)
 		generated_preds.set(iter.gp_iter, labelled_predicate);
@@ -107,6 +142,7 @@ void Analysis::State::setPredicate(PredIterator &iter, const LabelledPredicate &
 **/
 void Analysis::State::movePredicateToGenerated(PredIterator &iter)
 {
+	invalidateFingerprint();
 	if(iter.state == PredIterator::GENERATED_PREDS)
 		return; // do not do anything
 	else if(iter.state == PredIterator::LABELLED_PREDS)
@@ -120,6 +156,7 @@ void Analysis::State::movePredicateToGenerated(PredIterator &iter)
 
 void Analysis::State::removePredicate(PredIterator &iter)
 {
+	invalidateFingerprint();
 	ASSERT(!iter.ended());
 	if(iter.state == PredIterator::GENERATED_PREDS)
 		generated_preds.remove(iter.gp_iter);
@@ -165,6 +202,7 @@ io::Output& Analysis::State::print(io::Output& out) const
  */
 void Analysis::State::apply(const State& s, VarMaker& vm, bool local_sp, bool clear_path)
 {
+	invalidateFingerprint();
 	// DBG("f="<<this->dumpEverything() << ",\ng = " << s.dumpEverything())
 	Compositor cc(*this, local_sp);
 
@@ -245,6 +283,28 @@ void Analysis::State::apply(const State& s, VarMaker& vm, bool local_sp, bool cl
 	// DBG("f o g = " << color::IBlu() << this->dumpEverything())
 
 	// merge path
+	if(!alias_paths.isEmpty() || !s.alias_paths.isEmpty())
+	{	// our paths and the paths of s are all combined, (path, s.path) going to this->path
+		SLList<DetailedPath> ours(alias_paths), theirs(s.alias_paths);
+		ours.addFirst(path);
+		theirs.addFirst(s.path);
+		alias_paths.clear();
+		bool first = true;
+		for(SLList<DetailedPath>::Iterator pa(ours); pa; pa++)
+			for(SLList<DetailedPath>::Iterator pb(theirs); pb; pb++)
+			{
+				if(first)
+				{
+					first = false;
+					continue;
+				}
+				DetailedPath p(*pa);
+				if(clear_path)
+					p.clear();
+				p.apply(*pb);
+				alias_paths.addLast(p);
+			}
+	}
 	if(clear_path)
 		this->path.clear();
 	this->path.apply(s.getDetailedPath());
@@ -252,6 +312,7 @@ void Analysis::State::apply(const State& s, VarMaker& vm, bool local_sp, bool cl
 
 void Analysis::State::applyPredicates(const State& s, OperandEndoVisitor& cc, bool wipe_memory)
 {
+	invalidateFingerprint();
 	// update their predicates then add them to us
 	// be careful about multiplying per negative numbers? or not actually. I think it's a simple substitution
 	for(SLList<LabelledPredicate>::Iterator pi(s.labelled_preds); pi; pi++)
@@ -275,6 +336,7 @@ void Analysis::State::applyPredicates(const State& s, OperandEndoVisitor& cc, bo
  */
 void Analysis::State::prepareFixPoint()
 {
+	invalidateFingerprint();
 	for(LocalVariables::Iter i(lvars); i; i++)
 		if(lvars[i] && !lvars[i]->isAConst())
 			lvars[i] = NULL; // here, the "Top" is the state at the beginning of the loop iteration
@@ -310,6 +372,7 @@ const Operand* Analysis::State::widenArithmeticProgression(const Operand* x, con
  */
 void Analysis::State::widening(const Operand* n)
 {
+	invalidateFingerprint();
 	DBG("Starting widening with: " << dumpEverything())
 
 	WideningProgress wprogress(lvars); // lvars contains size info
@@ -437,7 +500,7 @@ Option<const Operand*> Analysis::State::widen(const Operand* x, const Operand& x
 		if(ready)
 		{
 			widenor.setSelf(&x0); // this will not consider x0 as a pointer from the DAG
-			x = x->accept(widenor);
+			x = staticEndoAccept(*x, widenor);
 			// at this point everything that isn't x0 is to be considered constant (for ex. if there's ?2 it's the ?2 of the beginning of the loop)
 			// we indeed want the x0_count from BEFORE the replacements
 			if(x == Top)
@@ -475,6 +538,7 @@ Option<const Operand*> Analysis::State::widen(const Operand* x, const Operand& x
  */
 void Analysis::State::finalizeLoop(OperandIter* n, VarMaker& vm)
 {
+	invalidateFingerprint();
 	n->finalize();
 }
 
@@ -484,6 +548,7 @@ void Analysis::State::finalizeLoop(OperandIter* n, VarMaker& vm)
  */
 void Analysis::State::merge(const States& ss, Block* b, VarMaker& vm)
 {
+	invalidateFingerprint();
 	ASSERTP(!ss.isEmpty(), "merging an empty list of states..."); // maybe just leave the state empty
 	DBGG("-\tmerging from " << ss.count() << " state(s).")
 
@@ -562,6 +627,7 @@ void Analysis::State::merge(const States& ss, Block* b, VarMaker& vm)
 	// this->path.merge(stateListToPathVector(sc)); // merge paths as well while keeping some flow info and shrink that in this->path
 	this->path.clear();
 	this->path.fromContext(b);
+	alias_paths.clear();
 	if(wipe_memory)
 	{
 		wipeMemory(vm);
@@ -625,6 +691,7 @@ void Analysis::State::collectTops(VarCollector& vc) const
  */
 void Analysis::State::removeTautologies(void)
 {
+	invalidateFingerprint();
 	for(LocalVariables::Iter i(lvars); i; i++)
 		if(lvars[i] && *lvars[i] == *i)
 			lvars[i] = NULL;
@@ -648,6 +715,7 @@ Analysis::State Analysis::topState(otawa::Block* entry) const
 
 void Analysis::State::initializeWithDFA()
 {
+	invalidateFingerprint();
 	for(dfa::State::MemIter mi(context->dfa_state); mi; mi++)
 	{
 		const dfa::MemCell& mc = *mi;
@@ -695,14 +763,28 @@ bool Analysis::State::equiv(const Analysis::State& s) const
 	if(! this->constants.sameValuesAs(s.constants))
 		return false;
 #endif
+	if(varsFingerprint() != s.varsFingerprint())
+		return false;
 	if(lvars != s.lvars)
 		return false;
 	// if(this->labelled_preds.count() != s.labelled_preds.count()) // This doesn't work because we sometimes add true values at each iteration
 	// 	return false;
-	for(SLList<LabelledPredicate>::Iterator self_iter(this->labelled_preds); self_iter; self_iter++)
+	if(!includesPredicates(s.labelled_preds, this->labelled_preds))
+		return false;
+	DBGG("-	" << color::IGre() << "FIXPOINT!")
+	DBG(s.dumpEverything())
+	return true;
+}
+
+/**
+ * @brief Checks that all the predicates of 'included' are in 'preds' (using Predicate::operator==, labels are ignored)
+ */
+bool Analysis::State::includesPredicates(const SLList<LabelledPredicate>& preds, const SLList<LabelledPredicate>& included)
+{
+	for(SLList<LabelledPredicate>::Iterator self_iter(included); self_iter; self_iter++)
 	{
 		bool contains = false;
-		for(SLList<LabelledPredicate>::Iterator s_iter(s.labelled_preds); s_iter; s_iter++)
+		for(SLList<LabelledPredicate>::Iterator s_iter(preds); s_iter; s_iter++)
 		{
 			if(self_iter->pred() == s_iter->pred())
 			{
@@ -713,17 +795,119 @@ bool Analysis::State::equiv(const Analysis::State& s) const
 		if(!contains)
 			return false;
 	}
-	DBGG("-	" << color::IGre() << "FIXPOINT!")
-	DBG(s.dumpEverything())
 	return true;
 }
 
+/**
+ * @fn elm::t::hash Analysis::State::fingerprint() const;
+ * @brief Hash of the values of the state (local variables, memory and predicates, but not the paths).
+ * Equal states have equal fingerprints. It is cached until the next modification of the state.
+ */
+elm::t::hash Analysis::State::fingerprint() const
+{
+	if(!fp_valid)
+	{
+		fp_vars = lvars.hash();
+		elm::t::hash h_mem = 0, h_preds = 0;
+		// order-independent combinations
+		for(mem_t::PairIterator i(mem); i; i++)
+			h_mem += ConstantHash::hash((*i).fst) * 31 + elm::t::hash((elm::t::intptr)(*i).snd);
+		for(PredIterator i(*this); i; i++)
+			h_preds += i.pred().hash();
+		fp = fp_vars ^ (h_mem * 0x9e3779b1) ^ (h_preds * 0x85ebca6b) ^ (bottom ? 1 : 0);
+		fp_valid = true;
+	}
+	return fp;
+}
+
+/**
+ * @fn bool Analysis::State::sameValuesAs(const State& s) const;
+ * @brief Checks that two states hold the same variables, memory and predicates (paths and labels are ignored)
+ */
+bool Analysis::State::sameValuesAs(const State& s) const
+{
+	if(bottom != s.bottom || context != s.context || fingerprint() != s.fingerprint())
+		return false;
+	if(lvars != s.lvars || memid.b != s.memid.b || memid.id != s.memid.id)
+		return false;
+	if(!generated_preds.isEmpty() || !generated_preds_taken.isEmpty() || !s.generated_preds.isEmpty() || !s.generated_preds_taken.isEmpty())
+		return false;
+	for(mem_t::PairIterator i(mem); i; i++)
+		if(s.mem.get((*i).fst, NULL) != (*i).snd)
+			return false;
+	for(mem_t::PairIterator i(s.mem); i; i++)
+		if(mem.get((*i).fst, NULL) != (*i).snd)
+			return false;
+	return includesPredicates(labelled_preds, s.labelled_preds) && includesPredicates(s.labelled_preds, labelled_preds);
+}
+
+/**
+ * @fn bool Analysis::State::sameLabelsAs(const State& s) const;
+ * @brief Checks that the predicates, constants and variables of two states with the same values carry the same labels
+ */
+bool Analysis::State::sameLabelsAs(const State& s) const
+{
+	if(!(constants == s.constants) || !lvars.sameLabelsAs(s.lvars))
+		return false;
+	for(SLList<LabelledPredicate>::Iterator i(labelled_preds); i; i++)
+	{
+		bool found = false;
+		for(SLList<LabelledPredicate>::Iterator j(s.labelled_preds); j && !found; j++)
+			found = i->pred() == j->pred() && i->labels() == j->labels();
+		if(!found)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * @fn void Analysis::State::copyValuesOf(const State& s);
+ * @brief Take all the values of s (variables, memory, predicates), but keep our paths
+ */
+void Analysis::State::copyValuesOf(const State& s)
+{
+	DetailedPath p(path);
+	SLList<DetailedPath> aliases(alias_paths);
+	*this = s;
+	path = p;
+	alias_paths = aliases;
+}
+
+/**
+ * @fn void Analysis::State::collapse(const State& s);
+ * @brief Absorb a state that has the same values as this one, keeping its paths
+ */
+void Analysis::State::collapse(const State& s)
+{
+	ASSERT(sameValuesAs(s));
+	alias_paths += s.path;
+	for(SLList<DetailedPath>::Iterator i(s.alias_paths); i; i++)
+		alias_paths += *i;
+}
+
+/**
+ * @fn void Analysis::State::uncollapse(Vector<State>& out) const;
+ * @brief Undo collapse: push to out one state per path of this one (its own path, then the alias paths), without alias paths
+ */
+void Analysis::State::uncollapse(Vector<State>& out) const
+{
+	State x(*this);
+	x.alias_paths.clear();
+	out.push(x);
+	for(SLList<DetailedPath>::Iterator i(alias_paths); i; i++)
+	{
+		x.path = *i;
+		out.push(x);
+	}
+}
+
 /**
  * @fn void Analysis::State::removeConstantPredicates();
  * @brief Removes constant predicates. Useful after a SMT call returning SAT, as the constant predicates of such states must be tautologies
  */
 void Analysis::State::removeConstantPredicates()
 {
+	invalidateFingerprint();
 	for(PredIterator piter(*this); piter; )
 	{
 		if(piter.pred().isConstant())
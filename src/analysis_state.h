@@ -70,15 +70,22 @@ private:
 	SLList<LabelledPredicate> generated_preds; // predicates local to the current BB
 	SLList<LabelledPredicate> generated_preds_taken; // if there is a conditional, the taken preds will be saved here and the not taken preds will stay in generated_preds
 		// that have been updated and need to have their labels list updated (add the next edge to the LabelledPreds struct)
+	SLList<DetailedPath> alias_paths; // paths of the states with the same values that were collapsed into this one
+	mutable elm::t::hash fp, fp_vars; // fingerprint of the state (paths excluded) and of its local variables, valid if fp_valid
+	mutable bool fp_valid;
 	class PredIterator;
 	class SemanticParser;
+	friend class Analysis::SummaryCache; // (de)serializes states
 
 public:
 	explicit State(bool bottom = false); // false: create an invalid state, true: create a bottom state
 	// State(Block* entryb, const context_t& context, bool init = true);
 	State(Edge* entry_edge, const context_t& context, DAG* dag, bool init);
 	State(const State& s);
+	static const int MAX_ALIAS_PATHS = 32; // paths a state may carry for the states collapsed into it
 	inline const DetailedPath& getDetailedPath() const { return path; }
+	inline const SLList<DetailedPath>& getAliasPaths() const { return alias_paths; }
+	inline int aliasCount() const { return alias_paths.count(); }
 	inline Edge* lastEdge() const { return path.lastEdge(); }
 	inline const SLList<LabelledPredicate>& getLabelledPreds() const { return labelled_preds; }
 #ifdef V1
@@ -87,9 +94,9 @@ public:
 	inline const LocalVariables& getLocalVariables() const { return lvars; }
 	inline const mem_t& getMemoryTable() const { return mem; }
 	// inline void onLoopEntry(Block* loop_header) { path.onLoopEntry(loop_header); }
-	inline void onLoopExit(Option<Block*> maybe_loop_header = elm::none) { path.onLoopExit(maybe_loop_header); }
-	inline void onCall(SynthBlock* sb)   { path.onCall(sb); }
-	inline void onReturn(SynthBlock* sb) { path.onReturn(sb); }
+	void onLoopExit(Option<Block*> maybe_loop_header = elm::none);
+	void onCall(SynthBlock* sb);
+	void onReturn(SynthBlock* sb);
 	inline bool isBottom() const { return bottom; }
 	inline bool isValid() const { return context != NULL; } // this is so that we can have empty states that do not use too much memory
 	inline DAG& getDag() const { return *dag; }
@@ -107,13 +114,20 @@ public:
 	void prepareFixPoint();
 	void finalizeLoop(OperandIter* n, VarMaker& vm);
 	bool equiv(const State& s) const;
+	elm::t::hash fingerprint() const;
+	inline elm::t::hash varsFingerprint() const { fingerprint(); return fp_vars; }
+	bool sameValuesAs(const State& s) const;
+	bool sameLabelsAs(const State& s) const;
+	void collapse(const State& s);
+	void uncollapse(Vector<State>& out) const;
+	void copyValuesOf(const State& s);
 	void appendEdge(Edge* e);
 	void removeConstantPredicates();
 	void collectTops(VarCollector &bv) const;
 	void removeTautologies();
-	inline void clearPreds() { labelled_preds.clear(); generated_preds.clear(); }
-	inline void clearPath() { path.clear(); }
-	inline void resetSP() { lvars[context->sp] = dag->cst(SP); }
+	inline void clearPreds() { labelled_preds.clear(); generated_preds.clear(); invalidateFingerprint(); }
+	void clearPath();
+	inline void resetSP() { lvars[context->sp] = dag->cst(SP); invalidateFingerprint(); }
 	void widening(const Operand* n);
 	LoopBound getLoopBound(const Operand* oi) const;
 
@@ -122,6 +136,7 @@ public:
 	void processSemInst1(const otawa::sem::inst& inst, const sem::inst& last_condition);
 	int  processSemInst2(SemanticParser& semp);
 	int invalidateStackBelow(const Constant& stack_limit);
+	int pruneDead(const BitVector& live);
 
 	inline void dumpPredicates() const { for(PredIterator iter(*this); iter; iter++) DBG(*iter); }
 	inline const State* operator->(void) const { return this; }
@@ -129,6 +144,8 @@ public:
 
 private:
 	// Private methods
+	inline void invalidateFingerprint() { fp_valid = false; }
+	static bool includesPredicates(const SLList<LabelledPredicate>& preds, const SLList<LabelledPredicate>& included);
 	// analysis.cpp
 	void setPredicate(PredIterator &iter, const LabelledPredicate &labelled_predicate);
 	void movePredicateToGenerated(PredIterator &iter);
@@ -25,12 +25,32 @@
 #include "analysis_states.h"
 #include "loop_bound.h"
 #include "struct/var_maker.h"
+#include "telemetry.h"
 
 // if this has n states and ss has m states, this will explode into a cartesian product of n*m states
 void Analysis::States::apply(const States& ss, VarMaker& vm, bool local_sp, bool dbg, bool clear_path)
 {
+	ASSERTP(ss.count() > 0, "TODO: handle empty states in entry")
+	// applying a collapsed state to another combines all their paths: past MAX_ALIAS_PATHS, work on the uncollapsed states
+	int ours = 1, theirs = 1;
+	for(int i = 0; i < this->count(); i++)
+		if(1 + s[i].aliasCount() > ours)
+			ours = 1 + s[i].aliasCount();
+	for(int i = 0; i < ss.count(); i++)
+		if(1 + ss.s[i].aliasCount() > theirs)
+			theirs = 1 + ss.s[i].aliasCount();
+	if(ours * theirs - 1 > State::MAX_ALIAS_PATHS)
+	{
+		DBGG("-\tuncollapsing states before apply (" << ours << "x" << theirs << " paths)")
+		uncollapse();
+		States expanded(ss);
+		expanded.uncollapse();
+		apply(expanded, vm, local_sp, dbg, clear_path);
+		return;
+	}
 	int new_cap, m = this->count(), n = ss.count(), new_length = m * n;
-	ASSERTP(n > 0, "TODO: handle empty states in entry")
+	telemetry.count(Telemetry::APPLIES);
+	telemetry.sample(Telemetry::APPLY_PRODUCT, new_length);
 	if(dbg && ss.first().getDetailedPath().hasAnEdge())
 		DBGG("Applying " << Dim() << ss.first().getDetailedPath().lastEdge()->target()->cfg() << RCol()
 			<< "(" << n << ") to " << m << " states, giving " << new_length << ".")
@@ -88,6 +108,56 @@ void Analysis::States::minimize(VarMaker& vm, bool clean) const
 	vm.shrink(vc, clean);
 }
 
+/**
+ * @fn int Analysis::States::collapseDuplicates();
+ * @brief Collapse the states that hold the same values into one representative that keeps all their paths
+ * @return the number of states removed
+ */
+int Analysis::States::collapseDuplicates()
+{
+	if(s.count() < 2)
+		return 0;
+	int removed = 0;
+	Vector<bool> dup(s.count());
+	for(int i = 0; i < s.count(); i++)
+		dup.add(false);
+	for(int i = 0; i < s.count(); i++)
+	{
+		if(dup[i])
+			continue;
+		elm::t::hash h = s[i].fingerprint();
+		for(int j = i+1; j < s.count(); j++)
+			if(!dup[j] && s[j].fingerprint() == h && s[i].aliasCount() + 1 + s[j].aliasCount() <= State::MAX_ALIAS_PATHS && s[i].sameValuesAs(s[j]))
+			{
+				s[i].collapse(s[j]);
+				dup[j] = true;
+				removed++;
+			}
+	}
+	if(removed)
+	{
+		Vector<State> kept(s.count() - removed);
+		for(int i = 0; i < s.count(); i++)
+			if(!dup[i])
+				kept.push(s[i]);
+		s = kept;
+		DBGG("-\tcollapsed " << removed << " duplicate states (" << s.count() << " left)")
+	}
+	return removed;
+}
+
+/**
+ * @fn void Analysis::States::uncollapse();
+ * @brief Undo collapseDuplicates: each state that carries alias paths is replaced by one state per path
+ */
+void Analysis::States::uncollapse()
+{
+	Vector<State> expanded(s.count());
+	for(int i = 0; i < s.count(); i++)
+		s[i].uncollapse(expanded);
+	s = expanded;
+}
+
 void Analysis::States::checkForSatisfiableSP(void) const
 {
 	Option<Constant> sp = none;
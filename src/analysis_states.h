@@ -47,6 +47,8 @@ public:
 	void apply(const States& ss, VarMaker& vm, bool local_sp, bool dbg = true, bool clear_path = false);
 	void appliedTo(const State& s, VarMaker& vm);
 	void minimize(VarMaker& vm, bool clean) const;
+	int collapseDuplicates();
+	void uncollapse();
 	inline void removeTautologies(void) 			{ for(Iter i(this->s); i; i++) s[i].removeTautologies(); }
 	inline void prepareFixPoint(void) 				{ for(Iter i(this->s); i; i++) s[i].prepareFixPoint(); }
 	void finalizeLoop(OperandIter* n, VarMaker& vm)	{ for(Iter i(this->s); i; i++) s[i].finalizeLoop(n, vm); }
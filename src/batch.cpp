@@ -0,0 +1,186 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <elm/assert.h>
+#include <elm/io.h>
+#include <elm/io/InFileStream.h>
+#include <elm/string.h>
+#include "batch.h"
+#include "debug.h"
+
+using namespace elm;
+
+/**
+ * @class Batch
+ * @brief Runs many analyses from one process.
+ * The manifest has one job per line: "<binary> <entry> [output=<file>] [merge=<n>] [j=<n>] [+<option>|-<option>]...",
+ * empty lines and lines starting with '#' are ignored.
+ * The caller loads each binary once, then forks one process per job, so that the decoded program is shared
+ * (copy-on-write) by all the jobs on this binary. Each job is charged the cores it analyzes with (at least one),
+ * and the running jobs never use more than max_running cores, unless a single job asks for more (it then runs alone).
+ * Each job records one line of results in the stats file; the ones that crash are recorded by the caller.
+ */
+Batch::Batch(int max_running, const elm::String& stats)
+	: _stats(stats), max_running(max_running > 0 ? max_running : int(sysconf(_SC_NPROCESSORS_ONLN))), running(0), _failed(0)
+	{ ASSERT(this->max_running > 0); }
+
+/**
+ * @fn bool Batch::read(const elm::String& manifest);
+ * @brief Read the jobs of a manifest
+ * @return false if the manifest could not be read or has a malformed line (which is reported)
+ */
+bool Batch::read(const elm::String& manifest)
+{
+	io::InFileStream in(manifest.toCString());
+	if(!in.isReady())
+	{
+		cerr << "Could not read " << manifest << endl;
+		return false;
+	}
+	StringBuffer buf;
+	char chunk[4096];
+	for(int n; (n = in.read(chunk, sizeof(chunk))) > 0; )
+		for(int i = 0; i < n; i++)
+			buf << chunk[i];
+	const String text = buf.toString();
+
+	int line_nb = 0;
+	for(int start = 0; start < text.length(); )
+	{
+		int end = text.indexOf('\n', start);
+		if(end < 0)
+			end = text.length();
+		const String line = text.substring(start, end - start);
+		start = end + 1;
+		line_nb++;
+
+		int i = 0;
+		while(i < line.length() && (line[i] == ' ' || line[i] == '\t'))
+			i++;
+		if(i == line.length() || line[i] == '#')
+			continue;
+		int j = i;
+		while(j < line.length() && line[j] != ' ' && line[j] != '\t')
+			j++;
+		Job job;
+		job.binary = line.substring(i, j - i);
+		if(!Server::parse(line.substring(j), job.req))
+		{
+			cerr << manifest << ":" << line_nb << ": malformed job \"" << line << "\"" << endl;
+			return false;
+		}
+		_jobs.push(job);
+	}
+	return true;
+}
+
+/**
+ * @fn pid_t Batch::fork(int job, int threads);
+ * @brief Start a job: wait until there are enough free cores for its threads, then fork
+ * @return 0 in the job process, its pid in the caller, -1 if it could not be started (it then counts as failed)
+ */
+pid_t Batch::fork(int job, int threads)
+{
+	const int cost = threads > 1 ? threads : 1;
+	reap(false);
+	while(running > 0 && running + cost > max_running)
+		reap(true);
+	cout.flush(); // do not let the job print what the caller buffered
+	cerr.flush();
+	const pid_t pid = ::fork();
+	if(pid < 0)
+		fail(job, "could not fork");
+	else if(pid > 0)
+	{
+		Child child;
+		child.pid = pid;
+		child.job = job;
+		child.cost = cost;
+		children.push(child);
+		running += cost;
+	}
+	return pid;
+}
+
+/**
+ * @fn int Batch::finish();
+ * @brief Wait for all the running jobs
+ * @return Count of failed jobs of the batch
+ */
+int Batch::finish()
+{
+	while(running > 0)
+		reap(true);
+	return _failed;
+}
+
+/**
+ * @fn void Batch::record(const elm::String& file, const elm::String& line);
+ * @brief Append a line to a file shared by the jobs. Lines are written in one call, so they are never interleaved.
+ */
+void Batch::record(const elm::String& file, const elm::String& line)
+{
+	const int fd = ::open(file.toCString(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if(fd < 0)
+		return;
+	const String s = _ << line << "\n";
+	if(::write(fd, s.chars(), s.length()) != ssize_t(s.length()))
+		DBGG("Could not record \"" << line << "\" in " << file)
+	::close(fd);
+}
+
+void Batch::reap(bool block)
+{
+	int status;
+	for(pid_t pid; running > 0 && (pid = waitpid(-1, &status, block ? 0 : WNOHANG)) != 0; block = false)
+	{
+		if(pid < 0)
+		{
+			running = 0; // no child left
+			children.clear();
+			return;
+		}
+		int i = 0;
+		while(i < children.length() && children[i].pid != pid)
+			i++;
+		if(i == children.length())
+			continue; // not a job
+		const Child child = children[i];
+		children.removeAt(i);
+		running -= child.cost;
+		if(WIFSIGNALED(status))
+			fail(child.job, _ << "killed by signal " << WTERMSIG(status));
+		else if(WEXITSTATUS(status) == RECORDED_FAILURE)
+			_failed++;
+		else if(WEXITSTATUS(status) != 0)
+			fail(child.job, _ << "exit status " << WEXITSTATUS(status));
+	}
+}
+
+// count a job as failed, and record it in the stats in place of the job
+void Batch::fail(int job, const elm::String& error)
+{
+	_failed++;
+	record(_stats, _ << _jobs[job].binary << "\t" << _jobs[job].req.entry << "\terror: " << error);
+}
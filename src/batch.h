@@ -0,0 +1,66 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#include <sys/types.h>
+#include "server.h"
+
+// Jobs of a batch manifest, run by forked processes that share the program loaded by their parent
+class Batch
+{
+public:
+	class Job {
+	public:
+		elm::String binary; // program to load
+		Server::Request req; // same syntax as the requests of the server mode
+	};
+
+	static const int RECORDED_FAILURE = 3; // exit status of a job that failed and recorded why
+
+	Batch(int max_running, const elm::String& stats);
+	bool read(const elm::String& manifest);
+	pid_t fork(int job, int threads);
+	int finish();
+	static void record(const elm::String& file, const elm::String& line);
+
+	inline const elm::genstruct::Vector<Job>& jobs() const { return _jobs; }
+	inline const elm::String& stats() const { return _stats; }
+	inline int failed() const { return _failed; }
+
+private:
+	class Child {
+	public:
+		pid_t pid;
+		int job; // index in the jobs
+		int cost; // cores charged for it
+	};
+	void reap(bool block);
+	void fail(int job, const elm::String& error);
+
+	elm::genstruct::Vector<Job> _jobs;
+	elm::genstruct::Vector<Child> children; // running jobs
+	elm::String _stats;
+	int max_running, running, _failed;
+};
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <elm/genstruct/HashTable.h>
+#include "cfg_snapshot.h"
+
+/**
+ * @class Analysis::CFGSnapshot
+ * @brief Flattened, index-based view of a CFG, computed once before running the fixpoint on it.
+ * Blocks are identified by their index and edges by a dense number, so that the loop information,
+ * the partitions of incoming edges and the traces on edges are all looked up in arrays.
+ */
+Analysis::CFGSnapshot::CFGSnapshot(CFG* cfg) : _cfg(cfg), block_count(cfg->count()), edge_count(0)
+{
+	// number blocks, then edges in block order (so that the edges of a block are contiguous)
+	Block** blocks = new Block*[block_count];
+	for(CFG::BlockIter b(cfg->blocks()); b; b++)
+		blocks[b->index()] = *b;
+	genstruct::HashTable<Edge*, int> ids;
+	for(int i = 0; i < block_count; i++)
+		for(Block::EdgeIter e(blocks[i]->outs()); e; e++)
+			ids.put(*e, edge_count++);
+
+	// per-block arrays
+	block_flags = new t::uint8[block_count];
+	lh_status = new status_t[block_count];
+	ins_off = new int[block_count+1];
+	ins_split = new int[block_count];
+	ins_data = new int[edge_count];
+	outs_off = new int[block_count+1];
+	outs_data = new int[edge_count];
+	loops_off = new int[block_count+1];
+	int loop_count = 0;
+	for(int i = 0; i < block_count; i++)
+		for(LoopHeaderIter lh(blocks[i]); lh; lh++)
+			loop_count++;
+	loops_data = new Block*[loop_count];
+
+	// per-edge arrays
+	edges = new Edge*[edge_count];
+	edge_flags = new t::uint8[edge_count];
+	exits_off = new int[edge_count+1];
+	slots = new LockPtr<States>[edge_count];
+	succ_buf = new int[edge_count];
+	int exit_count = 0;
+	for(int i = 0; i < block_count; i++)
+		for(Block::EdgeIter e(blocks[i]->outs()); e; e++)
+			if(Block* h = LOOP_EXIT_EDGE.get(*e, NULL))
+				for(LoopHeaderIter lh(blocks[i]); lh; lh++)
+				{
+					exit_count++;
+					if(*lh == h)
+						break;
+				}
+	exits_data = new Block*[exit_count];
+
+	int in_i = 0, out_i = 0, loop_i = 0, exit_i = 0;
+	for(int i = 0; i < block_count; i++)
+	{
+		Block* b = blocks[i];
+		block_flags[i] = (LOOP_HEADER(b) ? LOOP_HEADER_FLAG : 0) | (b->countOuts() > 1 ? CONDITIONAL_FLAG : 0);
+		lh_status[i] = ENTER;
+
+		// incoming edges: non-back edges first, then back edges
+		ins_off[i] = in_i;
+		for(Block::EdgeIter e(b->ins()); e; e++)
+			if(!BACK_EDGE(*e))
+				ins_data[in_i++] = ids.get(*e, -1);
+		ins_split[i] = in_i;
+		for(Block::EdgeIter e(b->ins()); e; e++)
+			if(BACK_EDGE(*e))
+				ins_data[in_i++] = ids.get(*e, -1);
+
+		// outgoing edges
+		outs_off[i] = out_i;
+		for(Block::EdgeIter e(b->outs()); e; e++)
+		{
+			const int id = ids.get(*e, -1);
+			outs_data[out_i++] = id;
+			edges[id] = *e;
+			edge_flags[id] = BACK_EDGE(*e) ? BACK_EDGE_FLAG : 0;
+			exits_off[id] = exit_i;
+			if(Block* h = LOOP_EXIT_EDGE.get(*e, NULL))
+			{
+				block_flags[i] |= HAS_EXITS_FLAG;
+				for(LoopHeaderIter lh(b); lh; lh++)
+				{
+					exits_data[exit_i++] = *lh;
+					if(*lh == h)
+						break;
+				}
+			}
+		}
+
+		// enclosing loops
+		loops_off[i] = loop_i;
+		for(LoopHeaderIter lh(b); lh; lh++)
+			loops_data[loop_i++] = *lh;
+	}
+	ins_off[block_count] = in_i;
+	outs_off[block_count] = out_i;
+	loops_off[block_count] = loop_i;
+	exits_off[edge_count] = exit_i;
+	ASSERT(in_i == edge_count && out_i == edge_count);
+	delete [] blocks;
+}
+
+Analysis::CFGSnapshot::~CFGSnapshot()
+{
+	delete [] block_flags;
+	delete [] lh_status;
+	delete [] ins_off;
+	delete [] ins_split;
+	delete [] ins_data;
+	delete [] outs_off;
+	delete [] outs_data;
+	delete [] loops_off;
+	delete [] loops_data;
+	delete [] edges;
+	delete [] edge_flags;
+	delete [] exits_off;
+	delete [] exits_data;
+	delete [] slots;
+	delete [] succ_buf;
+}
+
+/**
+ * @fn bool Analysis::CFGSnapshot::allLoopsLeave(Block* b) const;
+ * @brief Checks that all the loops enclosing b are in LEAVE status
+ */
+bool Analysis::CFGSnapshot::allLoopsLeave(Block* b) const
+{
+	loops_t l = loops(b);
+	for(int i = 0; i < l.count(); i++)
+		if(status(l[i]) != LEAVE)
+			return false;
+	return true;
+}
+
+/**
+ * @fn bool Analysis::CFGSnapshot::isAllowedExit(int e) const;
+ * @brief Checks that all the loops exited by edge e are in LEAVE status (always true for non-exit edges)
+ */
+bool Analysis::CFGSnapshot::isAllowedExit(int e) const
+{
+	loops_t l = exitedLoops(e);
+	for(int i = 0; i < l.count(); i++)
+		if(status(l[i]) != LEAVE)
+			return false;
+	return true;
+}
+
+/**
+ * @fn edges_t Analysis::CFGSnapshot::outsWithoutUnallowedExits(Block* b);
+ * @brief Collect the outgoing edges of b that pass the isAllowedExit check
+ * @return The selected edges, only valid until the next call
+ */
+Analysis::CFGSnapshot::edges_t Analysis::CFGSnapshot::outsWithoutUnallowedExits(Block* b)
+{
+	edges_t o = outs(b);
+	if(!hasExits(b))
+		return o;
+	int n = 0;
+	for(int i = 0; i < o.count(); i++)
+		if(isAllowedExit(o[i]))
+			succ_buf[n++] = o[i];
+	ASSERTP(n > 0 || b->isExit(), "outsWithoutUnallowedExits found no outs!")
+	return edges_t(succ_buf, n);
+}
+
+/**
+ * @fn bool Analysis::CFGSnapshot::allHaveTrace(const edges_t& es) const;
+ * @brief Checks for all edges to have a trace
+ */
+bool Analysis::CFGSnapshot::allHaveTrace(const edges_t& es) const
+{
+	for(int i = 0; i < es.count(); i++)
+		if(!hasTrace(es[i]))
+			return false;
+	return true;
+}
+
+/**
+ * @fn bool Analysis::CFGSnapshot::anyHasTrace(const edges_t& es) const;
+ * @brief Checks for at least one edge to have a trace
+ */
+bool Analysis::CFGSnapshot::anyHasTrace(const edges_t& es) const
+{
+	for(int i = 0; i < es.count(); i++)
+		if(hasTrace(es[i]))
+			return true;
+	return false;
+}
@@ -0,0 +1,121 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _CFG_SNAPSHOT_H
+#define _CFG_SNAPSHOT_H
+
+#include "analysis_states.h"
+
+/**
+ * Flattened view of a CFG for the fixpoint loop: blocks and edges are identified by dense indices,
+ * and the loop information and edge traces are held in arrays instead of property lists.
+ */
+class Analysis::CFGSnapshot
+{
+public:
+	typedef loopheader_status_t status_t;
+	// contiguous slice of one of the snapshot arrays
+	template <class T> class Range
+	{
+	public:
+		inline Range(const T* p, int n) : p(p), n(n) { }
+		inline int count(void) const { return n; }
+		inline bool isEmpty(void) const { return n == 0; }
+		inline const T& operator[](int i) const { ASSERT(0 <= i && i < n); return p[i]; }
+	private:
+		const T* p;
+		int n;
+	};
+	typedef Range<int> edges_t;
+	typedef Range<Block*> loops_t;
+
+	CFGSnapshot(CFG* cfg);
+	~CFGSnapshot();
+
+	// blocks
+	inline CFG* cfg(void) const { return _cfg; }
+	inline bool isLoopHeader(Block* b) const { return block_flags[b->index()] & LOOP_HEADER_FLAG; }
+	inline bool isConditional(Block* b) const { return block_flags[b->index()] & CONDITIONAL_FLAG; }
+	inline bool hasExits(Block* b) const { return block_flags[b->index()] & HAS_EXITS_FLAG; }
+	inline status_t status(Block* h) const { return lh_status[h->index()]; }
+	inline void setStatus(Block* h, status_t s) { ASSERT(isLoopHeader(h)); lh_status[h->index()] = s; }
+	inline loops_t loops(Block* b) const // enclosing loop headers, inmost first
+		{ return loops_t(loops_data + loops_off[b->index()], loops_off[b->index()+1] - loops_off[b->index()]); }
+	bool allLoopsLeave(Block* b) const;
+
+	// edge partitions
+	inline edges_t allIns(Block* b) const
+		{ return edges_t(ins_data + ins_off[b->index()], ins_off[b->index()+1] - ins_off[b->index()]); }
+	inline edges_t nonBackIns(Block* b) const
+		{ return edges_t(ins_data + ins_off[b->index()], ins_split[b->index()] - ins_off[b->index()]); }
+	inline edges_t backIns(Block* b) const
+		{ return edges_t(ins_data + ins_split[b->index()], ins_off[b->index()+1] - ins_split[b->index()]); }
+	inline edges_t outs(Block* b) const
+		{ return edges_t(outs_data + outs_off[b->index()], outs_off[b->index()+1] - outs_off[b->index()]); }
+	edges_t outsWithoutUnallowedExits(Block* b);
+
+	// edges
+	inline int countEdges(void) const { return edge_count; }
+	inline Edge* edge(int e) const { return edges[e]; }
+	inline bool isBack(int e) const { return edge_flags[e] & BACK_EDGE_FLAG; }
+	inline loops_t exitedLoops(int e) const // loops exited by the edge, inmost first
+		{ return loops_t(exits_data + exits_off[e], exits_off[e+1] - exits_off[e]); }
+	bool isAllowedExit(int e) const;
+
+	// edge traces
+	inline bool hasTrace(int e) const { return !slots[e].isNull(); }
+	bool allHaveTrace(const edges_t& es) const;
+	bool anyHasTrace(const edges_t& es) const;
+	inline LockPtr<States>& trace(int e) { ASSERT(0 <= e && e < edge_count); return slots[e]; }
+	inline void removeTrace(int e) { slots[e] = LockPtr<States>(); }
+
+private:
+	enum
+	{
+		LOOP_HEADER_FLAG = 1 << 0,
+		CONDITIONAL_FLAG = 1 << 1,
+		HAS_EXITS_FLAG	 = 1 << 2,
+	};
+	enum
+	{
+		BACK_EDGE_FLAG	 = 1 << 0,
+	};
+	CFGSnapshot(const CFGSnapshot&); // no copy
+
+	CFG* _cfg;
+	int block_count, edge_count;
+	// per block (indexed by block index), *_off arrays are of size block_count+1
+	t::uint8* block_flags;
+	status_t* lh_status;
+	int *ins_off, *ins_split, *ins_data;
+	int *outs_off, *outs_data;
+	int *loops_off;
+	Block** loops_data;
+	// per edge
+	Edge** edges;
+	t::uint8* edge_flags;
+	int* exits_off;
+	Block** exits_data;
+	LockPtr<States>* slots;
+	int* succ_buf; // returned by outsWithoutUnallowedExits
+};
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <otawa/sem/PathIter.h>
+#include "compiled_bb.h"
+
+Identifier<LockPtr<CompiledBB> > CompiledBB::ID("Semantic instructions of a BasicBlock, decoded");
+
+/**
+ * @class CompiledBB
+ * @brief Semantic instructions of a BasicBlock, decoded once and for all.
+ * processBB runs on every state and on every visit of the block during the fixpoint,
+ * this saves decoding the instructions and walking the sem::PathIter each time.
+ */
+CompiledBB::CompiledBB(const BasicBlock* bb)
+{
+	for(BasicBlock::InstIter i(bb); i; i++)
+	{
+		insts.push(*i);
+		inst_off.push(steps.length());
+		otawa::sem::PathIter seminsts;
+		for(seminsts.start(*i); seminsts; seminsts++)
+			steps.push(Step(*seminsts, seminsts.isCond(), seminsts.pathEnd()));
+	}
+	inst_off.push(steps.length());
+}
+
+/**
+ * @fn const CompiledBB& CompiledBB::of(const BasicBlock* bb);
+ * @brief Get the compiled semantic instructions of a BasicBlock, compiling them on the first call
+ */
+const CompiledBB& CompiledBB::of(const BasicBlock* bb)
+{
+	BasicBlock* b = const_cast<BasicBlock*>(bb);
+	if((*ID(b)).isNull())
+		ID(b) = LockPtr<CompiledBB>(new CompiledBB(bb));
+	return **ID(b);
+}
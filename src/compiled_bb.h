@@ -0,0 +1,68 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _COMPILED_BB_H
+#define _COMPILED_BB_H
+
+#include <elm/genstruct/Vector.h>
+#include <elm/util/LockPtr.h>
+#include <otawa/cfg/BasicBlock.h>
+#include <otawa/prop/Identifier.h>
+#include <otawa/sem/inst.h>
+
+using otawa::BasicBlock;
+using otawa::Identifier;
+using elm::LockPtr;
+
+// Semantic instructions of a BasicBlock, decoded once and stored in the order sem::PathIter visits them
+class CompiledBB : public elm::Lock
+{
+public:
+	class Step {
+	public:
+		enum { COND = 1 << 0, PATH_END = 1 << 1 };
+		inline Step() : flags(0) { }
+		inline Step(const otawa::sem::inst& inst, bool is_cond, bool path_end)
+			: inst(inst), flags((is_cond ? COND : 0) | (path_end ? PATH_END : 0)) { }
+		inline bool isCond() const { return flags & COND; }
+		inline bool pathEnd() const { return flags & PATH_END; }
+		otawa::sem::inst inst;
+		elm::t::uint8 flags;
+	};
+
+	static const CompiledBB& of(const BasicBlock* bb);
+
+	inline int countInsts() const { return insts.length(); }
+	inline otawa::Inst* inst(int i) const { return insts[i]; }
+	inline int firstStep(int i) const { return inst_off[i]; }
+	inline int endStep(int i) const { return inst_off[i+1]; }
+	inline const Step& step(int k) const { return steps[k]; }
+
+private:
+	CompiledBB(const BasicBlock* bb);
+
+	static Identifier<LockPtr<CompiledBB> > ID;
+	elm::genstruct::Vector<otawa::Inst*> insts;
+	elm::genstruct::Vector<int> inst_off; // the steps of insts[i] are [inst_off[i], inst_off[i+1][
+	elm::genstruct::Vector<Step> steps;
+};
+
+#endif
@@ -31,6 +31,7 @@
 #include "struct/predicate.h"
 
 // Compositor: a class for State composition
+// the result of each OperandArith node is memoized, since DAG nodes are shared between registers, memory cells and predicates
 class Compositor : public OperandEndoVisitor
 {
 	typedef genstruct::HashTable<Constant, const Operand*, ConstantHash> mem_t;
@@ -57,7 +58,13 @@ public:
 	const Operand* visit(const class OperandTop& g)  { return &g; } // this will be handled elsewhere by allocating a new top
 	const Operand* visit(const class OperandIter& g) { return &g; /*ASSERTP(false, "OperandIter found by the Compositor");*/ }
 	const Operand* visit(const class OperandArith& g)
-		{ return dag.smart_autoOp(g.opr(), g.leftOperand().accept(*this), g.isBinary() ? g.rightOperand().accept(*this) : NULL); }
+	{
+		if(const Operand* r = memo.get(&g, NULL))
+			return r;
+		const Operand* r = dag.smart_autoOp(g.opr(), staticEndoAccept(g.leftOperand(), *this), g.isBinary() ? staticEndoAccept(g.rightOperand(), *this) : NULL);
+		memo.put(&g, r);
+		return r;
+	}
 	// inline Predicate visit(const Predicate& p) { return Predicate(p.opr(), p.left()->accept(*this), p.right()->accept(*this)); }
 
 private:
@@ -65,6 +72,7 @@ private:
 	const Operand* sp;
 	const LocalVariables &lvars;
 	const mem_t &mem;
+	genstruct::HashTable<const Operand*, const Operand*> memo; // g -> f°g, for this composition only
 };
 
 #endif
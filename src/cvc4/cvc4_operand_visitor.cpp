@@ -89,13 +89,13 @@ bool CVC4OperandVisitor::visit(const class OperandArith& o)
 	if(!o.isComplete())
 		return false; // fail
 	Kind_t kind = getKind(o.opr());
-	if(!o.leftOperand().accept(*this))
+	if(!staticAccept(o.leftOperand(), *this))
 		return false;
 	Expr expr_left = expr;
 	
 	if(o.isBinary())
 	{
-		if(!o.rightOperand().accept(*this))
+		if(!staticAccept(o.rightOperand(), *this))
 			return false;
 		Expr expr_right = expr;
 		if(o.opr() == ARITHOPR_MULH) // special case: divide result by 2^32
@@ -130,7 +130,10 @@ bool CVC4SMT::checkPredSat()
 				smt.assertFormula(**iter, true); // second parameter to true for unsat cores
 				// std::cout << **iter << endl; // uncomment to print all asserted predicates
 			}
-		bool isSat = smt.checkSat(em.mkConst(true), true).isSat(); // check satisfability, the second parameter enables unsat cores
+		const CVC4::Result result = smt.checkSat(em.mkConst(true), true); // check satisfability, the second parameter enables unsat cores
+		bool isSat = result.isSat();
+		if(result.isUnknown())
+			status = UNKNOWN;
 		
 		if(!isSat) {
 			if(dbg_&0x1)
@@ -156,6 +159,7 @@ bool CVC4SMT::checkPredSat()
 	}
 	catch(CVC4::LogicException e)
 	{
+		status = FAILED;
 #ifdef DBG_WARNINGS
 		DBGW("non-linear call to CVC4, defaulting to SAT:")
 		std::cerr << e;
@@ -200,6 +200,19 @@ void DetailedPath::onReturn(SynthBlock* sb)
 	*/
 }
 
+/**
+ * @fn elm::t::hash DetailedPath::hash() const;
+ * @brief Hash of the sequence of flow info and of the function, so that equal paths have the same hash
+ */
+elm::t::hash DetailedPath::hash() const
+{
+	elm::Hasher h;
+	h << fun;
+	for(SLList<FlowInfo>::Iterator i(_path); i; i++)
+		h << i->hash();
+	return h;
+}
+
 /**
  * @fn bool DetailedPath::weakEqualsTo(const DetailedPath& dp) const;
  * @brief weak equality: test if the edge paths are the same - do not consider other flow info
@@ -24,6 +24,7 @@
 
 // #include <elm/genstruct/SLList.h> 
 #include <elm/genstruct/Vector.h>
+#include <elm/hash.h>
 #include <elm/string/String.h>
 #include <otawa/cfg/CFG.h>
 #include <otawa/cfg/features.h>
@@ -85,6 +86,7 @@ public:
 	inline const SLList<FlowInfo>& path() const { return _path; }
 	inline CFG* function() const { return fun; }
 	inline bool operator==(const DetailedPath& dp) const { return _path == dp._path && fun == dp.fun; }
+	elm::t::hash hash() const; // consistent with operator==
 	inline const DetailedPath* operator->(void) const { return this; }
 	friend io::Output& operator<<(io::Output& out, const DetailedPath& dp) { ASSERT(dp.fun); return dp.print(out); }
 
@@ -120,6 +122,7 @@ public:
 		elm::String toString(bool colored = true) const;
 		inline bool operator==(const FlowInfo& fi) const { return (_kind == fi._kind) && (_identifier == fi._identifier); }
 		inline bool operator!=(const FlowInfo& fi) const { return !this->operator==(fi); }
+		inline elm::t::hash hash() const { return elm::Hasher() << int(_kind) << _identifier; }
 		inline FlowInfo& operator=(const FlowInfo& fi) { _kind = fi._kind; _identifier = fi._identifier; return *this; }
 		inline const FlowInfo* operator->(void) const { return this; }
 		friend io::Output& operator<<(io::Output& out, const FlowInfo& fi) { return fi.print(out); }
@@ -29,102 +29,38 @@ io::Output& operator<<(io::Output& out, Vertex* b) {
 	return (out << b->index());
 }
 
-void BlockDominance::RPO::process(DiGraph *g)
-{
-	/* O ← [] */ // order
-	O.clear();
-	/* S ← [ε] */ // stack
-	genstruct::SLList<Vertex*> S;
-	S.add(g->entry());
-	/* D ← { } */ // done
-	genstruct::Vector<Vertex*> D;
-	/* while S ≠ [] do */
-	while(S) {
-		/* v ← hd S */
-		Vertex* v = S.first();
-		/* D ← D ∪ { v } */
-		if(! D.contains(v))
-			D.push(v);
-		/* if ∃ (v, w) ∈ E, w ∉ D then */
-		bool all_done = true;
-		for(Vertex::EdgeIter e(v->outs()); e; e++)
-			if(! D.contains(e->sink())) {
-				all_done = false;
-				/* S ← w :: S */
-				S.addFirst(e->sink());
-				break;
+BlockDominance::BlockDominance(DiGraph *g) : vertices(new Vertex*[g->count()]) {
+	const int n = g->count();
+	SemiNCA::adj_t *succs = new SemiNCA::adj_t[n], *preds = new SemiNCA::adj_t[n];
+	for(int i = 0; i < n; i++)
+		vertices[i] = NULL;
+	// collect the vertices reachable from the entry
+	genstruct::Vector<Vertex*> todo;
+	todo.push(g->entry());
+	vertices[g->entry()->index()] = g->entry();
+	while(todo) {
+		Vertex* v = todo.pop();
+		for(Vertex::EdgeIter e(v->outs()); e; e++) {
+			Vertex* w = e->sink();
+			succs[v->index()].push(w->index());
+			preds[w->index()].push(v->index());
+			if(!vertices[w->index()]) {
+				vertices[w->index()] = w;
+				todo.push(w);
 			}
-		/* else */
-		if(all_done) {
-			/* O ← v :: O */
-			O.addFirst(v);
-			/* S ← tl S */
-			S.removeFirst();
 		}
 	}
-}
-
-void BlockDominance::DominanceProblem(DiGraph *g) {
-	/* for all nodes, b // initialize the dominators array */
-		/* doms[b] ← Undefined */
-	doms.clear();
-	/* doms[start node] ← start node */
-	doms.put(g->entry(),g->entry());
-	/* Changed ← true */
-	bool changed = true;
-	/* while (Changed) */
-	while(changed) {
-		/* Changed ← false */
-		changed = false;
-		/* for all nodes, b, in reverse postorder (except start node) */
-		for(RPO::Iterator b(rpo.toList()); b; b++) {
-			if(b == g->entry())
-				continue;
-			/* new idom ← first (processed) predecessor of b // (pick one) */
-			Vertex* new_idom = NULL;
-			/* for all other predecessors, p, of b */
-			for(Vertex::EdgeIter pe(b->ins()); pe; pe++) {
-				/* if doms[p] != Undefined // i.e., if doms[p] already calculated */
-				if(doms.exists(pe->source()))
-					/* new idom ← intersect(p, new idom) */
-					new_idom = (new_idom==NULL) ? pe->source() : intersect(pe->source(), new_idom);
-			}
-			ASSERT(new_idom);
-			/* if doms[b] != new idom */
-			if(doms.get(b, NULL) != new_idom) {
-				/* doms[b] ← new idom */
-				doms.put(b, new_idom);
-				/* Changed ← true */
-				changed = true;
-			}
-		}
-	}
-}
-
-Vertex* BlockDominance::intersect(Vertex* b1, Vertex* b2) {
-	/* finger1 ← b1 */
-	/* finger2 ← b2 */
-	Vertex *finger1 = b1, *finger2 = b2;
-	/* while (finger1 != finger2) */
-	while(finger1 != finger2) {
-		/* while (finger1 < finger2) */
-		while(rpo.strictOrdered(finger1, finger2))
-			/* finger1 = doms[finger1] */
-			finger1 = doms[finger1];
-		/* while (finger2 < finger1) */
-		while(rpo.strictOrdered(finger2, finger1))
-			/* finger2 = doms[finger2] */
-			finger2 = doms[finger2];
-	}
-	/* return finger1 */
-	return finger1;
+	doms = new SemiNCA(n, g->entry()->index(), succs, preds);
+	delete[] succs;
+	delete[] preds;
 }
 
 io::Output& BlockDominance::print(io::Output& out) const {
 	bool first = true;
-	for(genstruct::HashTable<Vertex*, Vertex*>::PairIterator i(doms); i; i++) {
-		out << (first?"":",  ") << (*i).fst << ":" << (*i).snd;
-		first = false;
-	}
+	for(int i = 0; i < doms->count(); i++)
+		if(doms->reachable(i)) {
+			out << (first?"":",  ") << vertices[i] << ":" << vertices[doms->idom(i)];
+			first = false;
+		}
 	return out;
 }
@@ -32,6 +32,7 @@
 #include <otawa/sgraph/DiGraph.h>
 #include <otawa/prog/WorkSpace.h>
 #include <elm/genstruct/HashTable.h>
+#include "SemiNCA.h"
 
 // using namespace elm;
 using otawa::sgraph::DiGraph;
@@ -42,46 +43,20 @@ io::Output& operator<<(io::Output& out, Vertex* b); // TODO
 
 class BlockDominance {
 public:
-	class RPO {
-	public:
-		RPO(DiGraph* g) { process(g); }
-		const genstruct::SLList<Vertex*>& toList() const { return O; }
-		bool ordered(Vertex* a, Vertex* b) const { // test a <= b
-			for(Iterator i(O); i; i++) {
-				if(*i == a) return true; // a <= b
-				if(*i == b) return false; // a > b
-			}
-			ASSERTP(false, "rpo.ordered found neither " << a << " nor " << b);
-		}
-		inline bool strictOrdered(Vertex* a, Vertex* b) const { return !ordered(a,b); } // a < b = !(b <= a)
-
-		typedef genstruct::SLList<Vertex*>::Iterator Iterator;
-
-	private:
-		void process(DiGraph *g);
-		genstruct::SLList<Vertex*> O;
-	};
-
-	BlockDominance(DiGraph *g) : rpo(g) {
-		process(g);
-	}
+	BlockDominance(DiGraph *g);
+	~BlockDominance() { delete doms; delete[] vertices; }
 	Vertex* idom(Vertex* v) {
-		ASSERT(doms.exists(v));
-		return doms.get(v);
+		ASSERT(doms->reachable(v->index()));
+		return vertices[doms->idom(v->index())];
 	}
+	inline bool dominates(Vertex* v1, Vertex* v2) const { return doms->dominates(v1->index(), v2->index()); }
 
 private:
-	void process(DiGraph *g) {
-		DominanceProblem(g);
-	}
-	// dominance (new)
-	void DominanceProblem(DiGraph *g);
-	Vertex* intersect(Vertex* b1, Vertex* b2);
 	io::Output& print(io::Output& out) const; // print doms
 	inline friend io::Output& operator<<(io::Output& out, const BlockDominance& ed) { return ed.print(out); }
 	
-	RPO rpo;
-	genstruct::HashTable<Vertex*, Vertex*> doms;
+	Vertex** vertices; // by index
+	SemiNCA* doms;
 };
 
 template<class Vertex, class Edge>
@@ -33,6 +33,7 @@
 #include <otawa/prog/WorkSpace.h>
 // #include <elm/genstruct/SLList.h>
 #include <elm/genstruct/HashTable.h>
+#include "SemiNCA.h"
 #include "../debug.h"
 
 #define VIRTUAL_ENTRY_EDGE NULL
@@ -44,51 +45,23 @@ using otawa::sgraph::Vertex;
 
 io::Output& operator<<(io::Output& out, otawa::sgraph::Edge* e); // TODO
 
-class Order {
-public:
-	typedef otawa::sgraph::Edge edge_t;
-	// to implement
-	virtual Vertex::EdgeIter pred(edge_t* e) const = 0;
-	virtual Vertex::EdgeIter succ(edge_t* e) const = 0;
-
-	// Order(DiGraph* g, edge_t* start) { /*process(g, start);*/ }
-	const genstruct::SLList<edge_t*>& toList() const { return O; }
-	bool ordered(edge_t* a, edge_t* b) const { // test a <= b
-		if(!a) return true; // a=NULL: a <= b
-		if(!b) return false; // b=NULL: a < b
-		for(Iterator i(O); i; i++) {
-			if(*i == b) return true; // a <= b
-			if(*i == a) return false; // a > b
-		}
-		ASSERTP(false, "Order::ordered found neither " << a << " nor " << b);
-	}
-	inline bool strictOrdered(edge_t* a, edge_t* b) const { return !ordered(b,a); } // a < b = !(b <= a)
-
-	typedef genstruct::SLList<edge_t*>::Iterator Iterator;
-protected:
-	// void process(DiGraph *g, edge_t* start);
-	void process(DiGraph *g, genstruct::SLList<edge_t*> S);
-private:
-	genstruct::SLList<edge_t*> O;
-};
-
 template <class O> class EdgeDominance;
 
-// Reverse Post Order (for dominance)
-class RPO : public Order {
+// Reverse Post Order (for dominance): edges are followed forward
+class RPO {
 public:
-	RPO(DiGraph* g, const genstruct::SLList<edge_t*>& start) { process(g, start); }
-	inline virtual Vertex::EdgeIter pred(edge_t* e) const { return e->source()->ins(); }
-	inline virtual Vertex::EdgeIter succ(edge_t* e) const { return e->sink()->outs(); }
+	typedef otawa::sgraph::Edge edge_t;
+	static inline Vertex::EdgeIter pred(edge_t* e) { return e->source()->ins(); }
+	static inline Vertex::EdgeIter succ(edge_t* e) { return e->sink()->outs(); }
 };
 typedef EdgeDominance<RPO> EdgeDom;
 
-// Pre(Post?) Order (for post dominance)
-class PO : public Order {
+// Pre(Post?) Order (for post dominance): edges are followed backward
+class PO {
 public:
-	PO(DiGraph* g, const genstruct::SLList<edge_t*>& start) { process(g, start); }
-	inline virtual Vertex::EdgeIter pred(edge_t* e) const { return e->sink()->outs(); }
-	inline virtual Vertex::EdgeIter succ(edge_t* e) const { return e->source()->ins(); }
+	typedef otawa::sgraph::Edge edge_t;
+	static inline Vertex::EdgeIter pred(edge_t* e) { return e->sink()->outs(); }
+	static inline Vertex::EdgeIter succ(edge_t* e) { return e->source()->ins(); }
 };
 typedef EdgeDominance<PO> EdgePostDom;
 
@@ -97,97 +70,79 @@ class EdgeDominance {
 public:
 	typedef otawa::sgraph::Edge edge_t;
 
-	EdgeDominance(DiGraph *g, genstruct::SLList<edge_t*> start) : o(g, start) {
-		DominanceProblem(g, start);
+	EdgeDominance(DiGraph *g, genstruct::SLList<edge_t*> start) {
+		DominanceProblem(start);
 	}
+	~EdgeDominance() { delete doms; }
 	edge_t* idom(edge_t* e) {
-		ASSERT(doms.exists(e));
-		return doms.get(e);
+		ASSERT(ids.exists(e));
+		return edges[doms->idom(ids.get(e, -1))];
 	}
+	bool dominates(edge_t* e1, edge_t* e2) const { // O(1), edges out of reach of the start edges are never dominated
+		int k1 = ids.get(e1, -1), k2 = ids.get(e2, -1);
+		return k1 >= 0 && k2 >= 0 && doms->dominates(k1, k2);
+	}
+
+	// dominator tree, on edge numbers
+	inline int root() const { return doms->root(); }
+	inline edge_t* edge(int k) const { return edges[k]; }
+	inline int countChildren(int k) const { return doms->countChildren(k); }
+	inline int child(int k, int i) const { return doms->child(k, i); }
 
 private:
-	void DominanceProblem(DiGraph *g, genstruct::SLList<edge_t*> start) {
-		bool multiple_start = start.count() > 1;
-		/* for all nodes, e // initialize the dominators array */
-			/* doms[e] ← Undefined */
-		doms.clear();
-		/* doms[start edge] ← start edge */
-		// doms.put(start, start);
-		if(multiple_start) doms.put(VIRTUAL_ENTRY_EDGE, VIRTUAL_ENTRY_EDGE); // hack
+	void DominanceProblem(const genstruct::SLList<edge_t*>& start) {
+		// number the edges reachable from the start edges
 		for(genstruct::SLList<edge_t*>::Iterator i(start); i; i++)
-			if(multiple_start) doms.put(*i, VIRTUAL_ENTRY_EDGE); // hack	
-			else
-				doms.put(*i, *i);
-		/* Changed ← true */
-		bool changed = true;
-		/* while (Changed) */
-		while(changed) {
-			/* Changed ← false */
-			changed = false;
-			/* for all nodes, e, in reverse postorder (except start node) */
-			for(typename O::Iterator e(o.toList()); e; e++) {
-				// if(e == start)
-				if(start.contains(e))
-					continue;
-				/* new idom ← first (processed) predecessor of e // (pick one) */
-				Option<edge_t*> new_idom = none;
-				/* for all other predecessors, p, of e */
-				for(Vertex::EdgeIter p(o.pred(e)); p; p++) {
-					/* if doms[p] != Undefined // i.e., if doms[p] already calculated */
-					if(doms.exists(p))
-						/* new idom ← intersect(p, new idom) */
-						new_idom = new_idom ? intersect(p, new_idom) : p;
-				}
-				ASSERT(new_idom.isOne());
-				/* if doms[e] != new idom */
-				if(!doms.exists(e) || doms.get(e) != *new_idom) {
-					/* doms[e] ← new idom */
-					doms.put(e, new_idom);
-					/* Changed ← true */
-					changed = true;
+			number(*i);
+		for(int k = 0; k < edges.length(); k++)
+			for(Vertex::EdgeIter f(O::succ(edges[k])); f; f++)
+				number(*f);
+
+		// when there are several start edges, they are dominated by a virtual entry edge
+		const int n = edges.length();
+		const bool multiple_start = start.count() > 1;
+		if(multiple_start)
+			edges.push(VIRTUAL_ENTRY_EDGE);
+		SemiNCA::adj_t *succs = new SemiNCA::adj_t[edges.length()], *preds = new SemiNCA::adj_t[edges.length()];
+		for(int k = 0; k < n; k++)
+			for(Vertex::EdgeIter p(O::pred(edges[k])); p; p++) {
+				int j = ids.get(*p, -1);
+				if(j >= 0) {
+					succs[j].push(k);
+					preds[k].push(j);
 				}
 			}
-		}
+		if(multiple_start)
+			for(genstruct::SLList<edge_t*>::Iterator i(start); i; i++) {
+				succs[n].push(ids.get(*i, -1));
+				preds[ids.get(*i, -1)].push(n);
+			}
+		doms = new SemiNCA(edges.length(), multiple_start ? n : ids.get(start.first(), -1), succs, preds);
+		delete[] succs;
+		delete[] preds;
 	}
 
-	edge_t* intersect(edge_t* b1, edge_t* b2) {
-		// cout << "intersect(" << b1 << ", " << b2 << ")\n";
-		/* finger1 ← b1 */
-		/* finger2 ← b2 */
-		edge_t *finger1 = b1, *finger2 = b2;
-		/* while (finger1 != finger2) */
-		while(finger1 != finger2) {
-			/* while (finger1 < finger2) */
-			while(o.strictOrdered(finger1, finger2)) {
-				/* finger1 = doms[finger1] */
-				finger1 = doms[finger1];
-				if(!finger1) return VIRTUAL_ENTRY_EDGE;
-				// DBG("finger1= " << finger1)
-			}
-			/* while (finger2 < finger1) */
-			while(o.strictOrdered(finger2, finger1)) {
-				/* finger2 = doms[finger2] */
-				finger2 = doms[finger2];
-				if(!finger2) return VIRTUAL_ENTRY_EDGE;
-				// DBG("finger2= " << finger2)
-			}
+	inline void number(edge_t* e) {
+		if(!ids.exists(e)) {
+			ids.put(e, edges.length());
+			edges.push(e);
 		}
-		/* return finger1 */
-		return finger1;
 	}
 
 	io::Output& print(io::Output& out) const {
 		bool first = true;
-		for(genstruct::HashTable<edge_t*, edge_t*>::PairIterator i(doms); i; i++) {
-			out << (first?"":",  ") << (*i).fst << ":" << (*i).snd;
-			first = false;
-		}
+		for(int k = 0; k < doms->count(); k++)
+			if(edges[k] != VIRTUAL_ENTRY_EDGE && doms->reachable(k)) {
+				out << (first?"":",  ") << edges[k] << ":" << edges[doms->idom(k)];
+				first = false;
+			}
 		return out;
 	}
 	inline friend io::Output& operator<<(io::Output& out, const EdgeDominance& ed) { return ed.print(out); }
 	
-	O o;
-	genstruct::HashTable<edge_t*, edge_t*> doms;
+	genstruct::Vector<edge_t*> edges; // by number
+	genstruct::HashTable<edge_t*, int> ids;
+	SemiNCA* doms;
 };
 
 #endif /* EDGEDOMINANCE_H */
@@ -30,6 +30,7 @@
 #include <otawa/prog/WorkSpace.h>
 #include <otawa/pcg/PCG.h>
 #include <otawa/pcg/PCGBuilder.h>
+#include <elm/util/Pair.h>
 #include "BlockDominance.h"
 #include "EdgeDominance.h"
 #include "../cfg_features.h"
@@ -47,34 +48,8 @@ public:
 		EDGE_POSTDOM  = 1 << 2,
 	};
 
-	GlobalDominance(const otawa::CFGCollection *cfgs, int flags) {
-		for(otawa::CFGCollection::Iter cfg(cfgs); cfg; cfg++) {
-			DBG("Computing dominance for CFG: " << cfg->name())
-
-			if(flags&BLOCK_DOM) {
-				bdoms.put(*cfg, new BlockDominance(*cfg));
-				if(! (dbg_flags&DBG_DETERMINISTIC) )
-					DBG("\tbdoms: " << **bdoms[*cfg])
-			}
-
-			if(flags&EDGE_DOM) {
-				edoms.put(*cfg, new EdgeDom(*cfg, 
-					singleton<otawa::sgraph::Edge*>(theOnly(cfg->entry()->outs()))
-				));
-				if(! (dbg_flags&DBG_DETERMINISTIC) )
-					DBG("\tedoms: " << **edoms[*cfg])
-			}
-
-			if(flags&EDGE_POSTDOM) {
-				genstruct::SLList<otawa::sgraph::Edge*> sl; 
-				for(Block::EdgeIter i(cfg->exit()->ins()); i; i++)
-					sl += *i;
-				epdoms.put(*cfg, new EdgePostDom(*cfg, sl));
-				if(! (dbg_flags&DBG_DETERMINISTIC) )
-					DBG("\tepdoms: " << **epdoms[*cfg])
-			}
-		}
-	}
+	// the dominance of each CFG is only computed when it is first queried
+	GlobalDominance(const otawa::CFGCollection *cfgs, int flags) : cfgs(cfgs), flags(flags), call_tree_numbered(false) { }
 
 	~GlobalDominance() {
 		for(genstruct::HashTable<CFG*, BlockDominance*>::PairIterator i(bdoms); i; i++)
@@ -85,6 +60,21 @@ public:
 			delete (*i).snd;
 	}
 
+	// compute everything now, so that queries only read (e.g. to share this between threads)
+	void computeAll() const {
+		for(otawa::CFGCollection::Iter cfg(cfgs); cfg; cfg++) {
+			if(flags&BLOCK_DOM)
+				bdom(*cfg);
+			if(flags&EDGE_DOM)
+				edom(*cfg);
+			if(flags&EDGE_POSTDOM)
+				epdom(*cfg);
+		}
+		if((flags&EDGE_DOM) && cfg_follow_calls && !call_tree_numbered)
+			numberCallTree();
+	}
+
+	// all queries are interval checks on the dominator trees; only going up the call tree walks, for post-dominance
 	bool dom(Block* b1, Block* b2) const {
 		while(b2->cfg() != b1->cfg()) {
 			if(!cfg_follow_calls)
@@ -93,57 +83,128 @@ public:
 			if(!b2) // reached main, still didn't match b1's cfg, so b2 isn't even indirectly called by b1
 				return false;
 		}
-		while(b2 != b1) {
-			Block* prev_b2 = b2;
-			b2 = static_cast<Block*>((*bdoms.get(b2->cfg()))->idom(b2));
-			if(b2 == prev_b2) // reached entry
-				return false;
-		}
-		return true;
+		return bdom(b1->cfg())->dominates(b1, b2);
 	}
 	bool dom(otawa::Edge* e1, otawa::Edge* e2) const {
 		// a nice thing with dominance is that we don't need to check that the entry dominates the edge, it's always the case
-		while(e2->source()->cfg() != e1->source()->cfg()) {
-			if(!cfg_follow_calls)
-				return false;
-			Block* b = getCaller(e2->source()->cfg(), NULL);
-			if(!b) // reached main, still didn't match e1's cfg, so e2 isn't even indirectly called by e1
-				return false;
-			e2 = theOnly(b->ins());
-		}
-		while(e2 != e1) {
-			otawa::Edge* prev_e2 = e2;
-			e2 = static_cast<otawa::Edge*>((*edoms.get(e2->source()->cfg()))->idom(e2));
-			if(e2 == prev_e2) // reached entry
-				return false;
-		}
-		return true;
+		if(e1->source()->cfg() == e2->source()->cfg())
+			return edom(e1->source()->cfg())->dominates(e1, e2);
+		if(!cfg_follow_calls)
+			return false;
+		// e2 is in a (possibly indirect) callee: use the numbering of the call tree
+		if(!call_tree_numbered)
+			numberCallTree();
+		const interval_t none(-1, -1);
+		const interval_t i1 = call_tree.get(e1, none), i2 = call_tree.get(e2, none);
+		return i1.fst >= 0 && i2.fst >= 0 && i1.fst <= i2.fst && i2.snd <= i1.snd;
 	}
 	bool postdom(otawa::Edge* e1, otawa::Edge* e2) const {
 		// now we're going to have to check that the entry is post-dominated by the edge, everytime we go up in the caller tree
 		while(e1->source()->cfg() != e2->source()->cfg()) {
 			if(!cfg_follow_calls)
 				return false;
-			if(! postdom(e1, theOnly(e1->source()->cfg()->entry()->outs())) )
+			if(! epdom(e1->source()->cfg())->dominates(e1, theOnly(e1->source()->cfg()->entry()->outs())) )
 				return false; // e1 must post-dominate the entry edge of its cfg!
 			Block* b = getCaller(e1->source()->cfg(), NULL);
 			if(!b) // reached main, still didn't match e2's cfg, so e1 isn't even indirectly called by e2
 				return false;
 			e1 = theOnly(b->ins());
 		}
-		while(e2 != e1) {
-			otawa::Edge* prev_e2 = e2;
-			e2 = static_cast<otawa::Edge*>((*epdoms.get(e2->source()->cfg()))->idom(e2));
-			if(!e2 || e2 == prev_e2) // reached (virtual) exit
-				return false;
-		}
-		return true;
+		return epdom(e1->source()->cfg())->dominates(e1, e2);
 	}
 
 private:
-	genstruct::HashTable<CFG*, BlockDominance*> bdoms;
-	genstruct::HashTable<CFG*, EdgeDom*> edoms;
-	genstruct::HashTable<CFG*, EdgePostDom*> epdoms;
+	BlockDominance* bdom(CFG* cfg) const {
+		ASSERT(flags&BLOCK_DOM);
+		BlockDominance* d = bdoms.get(cfg, NULL);
+		if(!d) {
+			DBG("Computing block dominance for CFG: " << cfg->name())
+			bdoms.put(cfg, d = new BlockDominance(cfg));
+			if(! (dbg_flags&DBG_DETERMINISTIC) )
+				DBG("\tbdoms: " << *d)
+		}
+		return d;
+	}
+	EdgeDom* edom(CFG* cfg) const {
+		ASSERT(flags&EDGE_DOM);
+		EdgeDom* d = edoms.get(cfg, NULL);
+		if(!d) {
+			DBG("Computing edge dominance for CFG: " << cfg->name())
+			edoms.put(cfg, d = new EdgeDom(cfg, singleton<otawa::sgraph::Edge*>(theOnly(cfg->entry()->outs()))));
+			if(! (dbg_flags&DBG_DETERMINISTIC) )
+				DBG("\tedoms: " << *d)
+		}
+		return d;
+	}
+	EdgePostDom* epdom(CFG* cfg) const {
+		ASSERT(flags&EDGE_POSTDOM);
+		EdgePostDom* d = epdoms.get(cfg, NULL);
+		if(!d) {
+			DBG("Computing edge post-dominance for CFG: " << cfg->name())
+			genstruct::SLList<otawa::sgraph::Edge*> sl; 
+			for(Block::EdgeIter i(cfg->exit()->ins()); i; i++)
+				sl += *i;
+			epdoms.put(cfg, d = new EdgePostDom(cfg, sl));
+			if(! (dbg_flags&DBG_DETERMINISTIC) )
+				DBG("\tepdoms: " << *d)
+		}
+		return d;
+	}
+
+	/**
+	 * Number the edge dominator trees of all CFGs as a single tree, where the tree of a callee hangs below the edge
+	 * entering its call block. e1 then dominates e2 (possibly in a callee) iff its interval includes the one of e2.
+	 */
+	void numberCallTree() const {
+		genstruct::HashTable<otawa::Edge*, CFG*> callees; // edge entering a call block -> called CFG
+		genstruct::Vector<CFG*> roots;
+		for(otawa::CFGCollection::Iter cfg(cfgs); cfg; cfg++) {
+			if(Block* b = getCaller(*cfg, NULL))
+				callees.put(theOnly(b->ins()), *cfg);
+			else
+				roots.push(*cfg);
+		}
+		int counter = 0;
+		genstruct::Vector<frame_t> stack;
+		for(int r = 0; r < roots.length(); r++) {
+			EdgeDom* d = edom(roots[r]);
+			stack.push(frame_t(d, d->root()));
+			call_tree.put(static_cast<otawa::Edge*>(d->edge(d->root())), interval_t(counter++, -1));
+			while(stack) {
+				frame_t& f = stack[stack.length()-1];
+				otawa::Edge* e = static_cast<otawa::Edge*>(f.d->edge(f.k));
+				CFG* callee = callees.get(e, NULL);
+				if(f.i < f.d->countChildren(f.k) + (callee ? 1 : 0)) {
+					// children in the dominator tree, then the tree of the callee
+					frame_t g = (f.i < f.d->countChildren(f.k)) ? frame_t(f.d, f.d->child(f.k, f.i)) : frame_t(edom(callee), edom(callee)->root());
+					f.i++;
+					call_tree.put(static_cast<otawa::Edge*>(g.d->edge(g.k)), interval_t(counter++, -1));
+					stack.push(g);
+				}
+				else {
+					call_tree.put(e, interval_t(call_tree.get(e, interval_t(-1, -1)).fst, counter++));
+					stack.pop();
+				}
+			}
+		}
+		call_tree_numbered = true;
+	}
+
+	typedef Pair<int, int> interval_t;
+	class frame_t {
+	public:
+		inline frame_t(EdgeDom* d = NULL, int k = -1) : d(d), k(k), i(0) { }
+		EdgeDom* d;
+		int k, i; // node, next child
+	};
+
+	const otawa::CFGCollection *cfgs;
+	int flags;
+	mutable bool call_tree_numbered;
+	mutable genstruct::HashTable<otawa::Edge*, interval_t> call_tree;
+	mutable genstruct::HashTable<CFG*, BlockDominance*> bdoms;
+	mutable genstruct::HashTable<CFG*, EdgeDom*> edoms;
+	mutable genstruct::HashTable<CFG*, EdgePostDom*> epdoms;
 	// BlockDominanceGen<PCGBlock, PCGEdge> pcg_dom;
 };
 
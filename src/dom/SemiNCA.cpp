@@ -0,0 +1,167 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+/*
+ * SemiNCA.cpp
+ */
+
+#include "SemiNCA.h"
+
+SemiNCA::SemiNCA(int n, int root, const adj_t* succs, const adj_t* preds) : n(n), _root(root), _idom(new int[n]) {
+	// everything below is numbered in DFS preorder
+	int *pre = new int[n], *vertex = new int[n], *parent = new int[n];
+	int *semi = new int[n], *label = new int[n], *ancestor = new int[n], *idom = new int[n];
+	for(int v = 0; v < n; v++) {
+		pre[v] = -1;
+		_idom[v] = -1;
+	}
+
+	// iterative DFS from the root
+	int count = 0;
+	elm::genstruct::Vector<int> stack, next; // node, index of its next successor to visit
+	pre[root] = count;
+	vertex[count] = root;
+	parent[count++] = 0;
+	stack.push(root);
+	next.push(0);
+	while(stack) {
+		int v = stack.top();
+		int& k = next[next.length()-1];
+		if(k < succs[v].length()) {
+			int w = succs[v][k++];
+			if(pre[w] < 0) {
+				pre[w] = count;
+				vertex[count] = w;
+				parent[count++] = pre[v];
+				stack.push(w);
+				next.push(0);
+			}
+		}
+		else {
+			stack.pop();
+			next.pop();
+		}
+	}
+
+	// semi-dominators, processed in reverse preorder, with a path-compressed forest
+	for(int i = 0; i < count; i++) {
+		semi[i] = i;
+		label[i] = i;
+		ancestor[i] = -1;
+	}
+	for(int i = count-1; i > 0; i--) {
+		const adj_t& ps = preds[vertex[i]];
+		for(int k = 0; k < ps.length(); k++) {
+			int j = pre[ps[k]];
+			if(j < 0) // unreachable predecessor
+				continue;
+			int s = semi[eval(j, ancestor, label, semi)];
+			if(s < semi[i])
+				semi[i] = s;
+		}
+		ancestor[i] = parent[i];
+	}
+
+	// immediate dominators: the nearest common ancestor of the parent and the semi-dominator
+	idom[0] = 0;
+	for(int i = 1; i < count; i++) {
+		int j = parent[i];
+		while(j > semi[i])
+			j = idom[j];
+		idom[i] = j;
+	}
+	for(int i = 0; i < count; i++)
+		_idom[vertex[i]] = vertex[idom[i]];
+
+	delete[] pre;
+	delete[] vertex;
+	delete[] parent;
+	delete[] semi;
+	delete[] label;
+	delete[] ancestor;
+	delete[] idom;
+	number();
+}
+
+/**
+ * @brief Build the children lists of the dominator tree, and number it with DFS intervals
+ */
+void SemiNCA::number() {
+	child_off = new int[n+1];
+	child_data = new int[n];
+	_in = new int[n];
+	_out = new int[n];
+	for(int v = 0; v <= n; v++)
+		child_off[v] = 0;
+	for(int v = 0; v < n; v++)
+		if(reachable(v) && v != _root)
+			child_off[_idom[v]+1]++;
+	for(int v = 0; v < n; v++)
+		child_off[v+1] += child_off[v];
+	int* fill = new int[n];
+	for(int v = 0; v < n; v++)
+		fill[v] = child_off[v];
+	for(int v = 0; v < n; v++)
+		if(reachable(v) && v != _root)
+			child_data[fill[_idom[v]]++] = v;
+	delete[] fill;
+
+	int counter = 0;
+	elm::genstruct::Vector<int> stack, next;
+	_in[_root] = counter++;
+	stack.push(_root);
+	next.push(0);
+	while(stack) {
+		int v = stack.top();
+		int& i = next[next.length()-1];
+		if(i < countChildren(v)) {
+			int w = child(v, i++);
+			_in[w] = counter++;
+			stack.push(w);
+			next.push(0);
+		}
+		else {
+			_out[v] = counter++;
+			stack.pop();
+			next.pop();
+		}
+	}
+}
+
+/**
+ * @brief Find the node of minimal semi-dominator on the path from v to the root of its tree, compressing that path
+ */
+int SemiNCA::eval(int v, int* ancestor, int* label, const int* semi) const {
+	if(ancestor[v] < 0)
+		return v;
+	// collect the path up to the last node that has an ancestor, then compress it from the top
+	elm::genstruct::Vector<int> path;
+	for(int u = v; ancestor[ancestor[u]] >= 0; u = ancestor[u])
+		path.push(u);
+	while(path) {
+		int u = path.pop();
+		int a = ancestor[u];
+		if(semi[label[a]] < semi[label[u]])
+			label[u] = label[a];
+		ancestor[u] = ancestor[a];
+	}
+	return label[v];
+}
@@ -0,0 +1,62 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+/*
+ * SemiNCA.h
+ */
+
+#ifndef SEMINCA_H
+#define SEMINCA_H
+
+#include <elm/genstruct/Vector.h>
+
+// Immediate dominators of a graph of nodes numbered 0..n-1, computed by the SEMI-NCA algorithm
+// (Georgiadis, "Linear-Time Algorithms for Dominators and Related Problems", 2005) in near-linear time.
+// The dominator tree is then numbered with DFS intervals, so that dominance queries take constant time
+class SemiNCA {
+public:
+	typedef elm::genstruct::Vector<int> adj_t;
+
+	SemiNCA(int n, int root, const adj_t* succs, const adj_t* preds);
+	~SemiNCA() { delete[] _idom; delete[] _in; delete[] _out; delete[] child_off; delete[] child_data; }
+	inline int count() const { return n; }
+	inline int root() const { return _root; }
+	inline int idom(int v) const { return _idom[v]; } // the root for the root, -1 if v is unreachable
+	inline bool reachable(int v) const { return _idom[v] >= 0; }
+	inline bool dominates(int a, int b) const // a dominates b (a == b included)
+		{ return reachable(a) && reachable(b) && _in[a] <= _in[b] && _out[b] <= _out[a]; }
+
+	// dominator tree
+	inline int countChildren(int v) const { return child_off[v+1] - child_off[v]; }
+	inline int child(int v, int i) const { return child_data[child_off[v] + i]; }
+
+private:
+	int eval(int v, int* ancestor, int* label, const int* semi) const;
+	void number();
+
+	int n, _root;
+	int* _idom;
+	int *_in, *_out; // DFS interval of each node in the dominator tree
+	int *child_off, *child_data; // children in the dominator tree, child_data[child_off[v]..child_off[v+1][
+
+};
+
+#endif /* SEMINCA_H */
@@ -30,6 +30,14 @@ namespace otawa {
 	extern Identifier<int> ANALYSIS_FLAGS; // mandatory
 	extern Identifier<int> MERGE_THRESOLD; // optional
 	extern Identifier<int> NB_CORES; // optional
+	extern Identifier<int> TRANSFER_CACHE_SIZE; // optional
+	extern Identifier<elm::String> SUMMARY_CACHE_PATH; // optional
+	extern Identifier<elm::String> RESULT_CACHE_PATH; // optional
+	extern Identifier<bool> RESIDENT_SUMMARIES; // optional
+	extern Identifier<elm::String> FFX_STREAM_PATH; // optional
+	extern Identifier<elm::String> SUMMARY_CHECKPOINT; // optional
+	extern Identifier<int> SUMMARY_CHECKPOINT_INTERVAL; // optional
+	extern Identifier<bool> RESUME_SUMMARIES; // optional
 
 	// PathFinder output (on the called CFG)
 	extern Identifier<Vector<DetailedPath> > INFEASIBLE_PATHS;
@@ -19,8 +19,13 @@
  *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <elm/io/BlockOutStream.h>
+#include "cfg_features.h"
 #include "debug.h"
 #include "ffx.h"
+#include "ipb/ipb.h"
 #include "pretty_printing.h"
 
 // TODO! do so that when there is NO LEx after a LEn, we use iteration=*
@@ -34,7 +39,12 @@
  * @brief Initialize the FFX output module with the result of an Infeasible Path analysis
  * @param ips The Vector of infeasible paths returned by the analysis
  */
-FFX::FFX(const Vector<DetailedPath>& ips) : infeasible_paths(ips), indent_level(0) { }
+FFX::FFX(const Vector<DetailedPath>& ips) : infeasible_paths(ips), indent_level(0), fd(-1), index_fd(-1), end(0), streamed_function(NULL) { }
+
+FFX::~FFX()
+{
+	close();
+}
 
 /**
  * @fn void FFX::output(const elm::String& function_name, const elm::String& ffx_filename, const elm::String& graph_filename);
@@ -80,46 +90,532 @@ void FFX::output(const elm::String& function_name, const elm::String& ffx_filena
 	}
 }
 
-void FFX::sanitizeCallReturns(void)
+// string, address, edge and call tables of the binary output, see ipb/ipb.h
+class BinaryTables
 {
-	for(Vector<DetailedPath>::Iter ip(infeasible_paths); ip; ip++)
+public:
+	BinaryTables() : address_ids(1024), pair_ids(1024), string_ids(211) { }
+
+	t::uint32 address(Address a)
+	{
+		const t::uint32 offset = a.offset();
+		if(!address_ids.hasKey(offset))
+		{
+			address_ids.put(offset, addresses.length());
+			addresses.push(offset);
+		}
+		return address_ids.get(offset, 0);
+	}
+	t::uint32 edge(Address src, Address dst)
+	{
+		const t::uint32 s = address(src), d = address(dst);
+		const t::uint64 key = (t::uint64(s) << 32) | d;
+		if(!pair_ids.hasKey(key))
+		{
+			pair_ids.put(key, edges.length() / 2);
+			edges.push(s);
+			edges.push(d);
+		}
+		return pair_ids.get(key, 0);
+	}
+	t::uint32 call(Address callpoint, Address callee, const elm::String& name)
 	{
-		Vector<CFG*> caller_q;
-		Vector<Option<SynthBlock*> > callers;
-			caller_q.push(ip->function());
-			callers.push(elm::none);
-		for(DetailedPath::Iterator iter(ip); iter; iter++)
+		const t::uint32 p = address(callpoint), c = address(callee);
+		const t::uint64 key = (t::uint64(1) << 63) | (t::uint64(p) << 32) | c; // kept apart from edge keys
+		if(!pair_ids.hasKey(key))
 		{
-			if(iter->isEdge())
+			pair_ids.put(key, calls.length() / 3);
+			calls.push(p);
+			calls.push(c);
+			calls.push(string(name));
+		}
+		return pair_ids.get(key, 0);
+	}
+	t::uint32 string(const elm::String& s)
+	{
+		if(!string_ids.hasKey(s))
+		{
+			string_ids.put(s, strings.length());
+			for(int i = 0; i < s.length(); i++)
+				strings.push(s[i]);
+			strings.push('\0');
+		}
+		return string_ids.get(s, 0);
+	}
+
+	Vector<t::uint32> addresses, edges, calls;
+	Vector<char> strings;
+
+private:
+	HashTable<t::uint32, t::uint32> address_ids;
+	HashTable<t::uint64, t::uint32> pair_ids;
+	HashTable<elm::String, t::uint32> string_ids;
+};
+
+static void putWord(Vector<t::uint8>& bytes, t::uint32 w)
+{
+	for(int i = 0; i < 4; i++)
+		bytes.push(t::uint8(w >> (8 * i)));
+}
+
+static void putWords(Vector<t::uint8>& bytes, const Vector<t::uint32>& ws, t::uint32 offset = 0)
+{
+	for(int i = 0; i < ws.length(); i++)
+		putWord(bytes, ws[i] + offset);
+}
+
+/**
+ * @fn bool FFX::outputBinary(const elm::String& function_name, const elm::String& ipb_filename);
+ * @brief Output the result of the analysis in the compact binary format described in ipb/ipb.h
+ * @param function_name Name of the function analysed
+ * @param ipb_filename Full name of the file to output to
+ * @return false if the file could not be written
+ */
+bool FFX::outputBinary(const elm::String& function_name, const elm::String& ipb_filename)
+{
+	sanitizeCallReturns();
+	BinaryTables tables;
+	Vector<t::uint32> offsets, records; // offsets are relative to the first record until the layout is known
+	const t::uint32 entry = tables.string(function_name);
+
+	// same order as the FFX output
+	Vector<CFG*> funs;
+	for(Vector<DetailedPath>::Iter iter(infeasible_paths); iter; iter++)
+		if(!funs.contains(iter->function()))
+			funs.push(iter->function());
+	for(Vector<CFG*>::Iter i(funs); i; i++)
+		for(Vector<DetailedPath>::Iter iter(infeasible_paths); iter; iter++)
+		{
+			if(iter->function() != *i || !checkPathValidity(*iter, false))
+				continue;
+			Vector<Element> elems;
+			elementsOf(*iter, elems);
+			offsets.push(records.length());
+			records.push(tables.string(i->name()));
+			const int count = records.length();
+			records.push(0);
+			for(Vector<Element>::Iter e(elems); e; e++)
+				switch(e->kind)
+				{
+					case Element::EDGE:
+						records.push(ipb::token(ipb::EDGE, tables.edge(e->a, e->b)));
+						break;
+					case Element::LOOP:
+						records.push(ipb::token(e->all_iterations ? ipb::LOOP_ALL : ipb::LOOP_N, tables.address(e->a)));
+						break;
+					case Element::END_LOOP:
+						records.push(ipb::token(ipb::END_LOOP));
+						break;
+					case Element::CALL:
+						records.push(ipb::token(ipb::CALL, tables.call(e->a, e->b, e->name)));
+						break;
+					case Element::RETURN:
+						records.push(ipb::token(ipb::RETURN));
+						break;
+					case Element::COMMENT:
+						break;
+				}
+			records[count] = records.length() - count - 1;
+		}
+
+	// layout
+	ipb::header_t h;
+	h.magic = ipb::MAGIC;
+	h.version = ipb::VERSION;
+	h.byte_order = ipb::BYTE_ORDER_MARK;
+	h.entry = entry;
+	h.address_count = tables.addresses.length();
+	h.edge_count = tables.edges.length() / 2;
+	h.call_count = tables.calls.length() / 3;
+	h.path_count = offsets.length();
+	h.string_size = tables.strings.length();
+	h.addresses = sizeof(ipb::header_t) / 4;
+	h.edges = h.addresses + tables.addresses.length();
+	h.calls = h.edges + tables.edges.length();
+	h.paths = h.calls + tables.calls.length();
+	const t::uint32 first_record = h.paths + offsets.length();
+	h.strings = (first_record + records.length()) * 4;
+
+	Vector<t::uint8> bytes(h.strings + h.string_size);
+	const t::uint32* hw = reinterpret_cast<const t::uint32*>(&h);
+	for(unsigned int i = 0; i < sizeof(ipb::header_t) / 4; i++)
+		putWord(bytes, hw[i]);
+	putWords(bytes, tables.addresses);
+	putWords(bytes, tables.edges);
+	putWords(bytes, tables.calls);
+	putWords(bytes, offsets, first_record);
+	putWords(bytes, records);
+	for(int i = 0; i < tables.strings.length(); i++)
+		bytes.push(t::uint8(tables.strings[i]));
+
+	const int ipb_fd = ::open(ipb_filename.toCString(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(ipb_fd < 0)
+		return false;
+	bool ok = ::write(ipb_fd, &bytes[0], bytes.length()) == ssize_t(bytes.length());
+	ok = ::close(ipb_fd) == 0 && ok;
+	if(ok && dbg_verbose < DBG_VERBOSE_NONE)
+		cout << "binary output to " + ipb_filename << endl;
+	return ok;
+}
+
+// insert into a sorted vector, keeping its items unique
+static void insertSorted(Vector<int>& v, int x)
+{
+	int i = 0;
+	while(i < v.length() && v[i] < x)
+		i++;
+	if(i == v.length() || v[i] != x)
+		v.insert(i, x);
+}
+
+static elm::String keyOf(const Vector<int>& path, int skip = -1)
+{
+	StringBuffer key;
+	for(int k = 0; k < path.length(); k++)
+		if(k != skip)
+			key << path[k] << ",";
+	return key.toString();
+}
+
+// key of the group of paths that differ from path by the edge at index j only
+static elm::String groupKey(const Vector<int>& path, int j, const Vector<t::uint32>& sources)
+{
+	return _ << io::hex(sources[path[j]]) << ":" << keyOf(path, j);
+}
+
+// append i to the vector of key k, the vectors are owned by the table (see freeIndex)
+template <class K>
+static void addToIndex(HashTable<K, Vector<int>*>& index, const K& k, int i)
+{
+	Vector<int>* v = index.get(k, NULL);
+	if(!v)
+	{
+		v = new Vector<int>();
+		index.put(k, v);
+	}
+	v->push(i);
+}
+
+template <class K>
+static void freeIndex(HashTable<K, Vector<int>*>& index)
+{
+	for(typename HashTable<K, Vector<int>*>::PairIterator i(index); i; i++)
+		delete (*i).snd;
+}
+
+// true if the block runs more than once per execution of its function
+static bool inLoop(const Block* b)
+{
+	return LOOP_HEADER(b) || ENCLOSING_LOOP_HEADER.get(b, NULL);
+}
+
+/**
+ * @fn bool FFX::outputConstraints(const elm::String& function_name, const elm::String& lp_filename);
+ * @brief Output the infeasible paths as IPET constraints over the execution counts of edges, in lp_solve LP format
+ * @param function_name Name of the function analysed
+ * @param lp_filename Full name of the file to output to
+ * @return false if the file could not be written
+ *
+ * An infeasible path can only be excluded once per execution of its context: a path of edges e1..ek of function f gives
+ * e1 + ... + ek <= (k-1) n_f, where n_f is the number of executions of f. Only paths whose edges are outside of loops are
+ * encoded, as each of their edges then runs at most once per execution of f. This makes duplicated paths and paths containing
+ * another path redundant, and paths that only differ by one edge leaving the same block can share a single constraint
+ * (R + a + b <= |R| n_f for the paths R+a and R+b). Paths in loop or call contexts are not encoded.
+ */
+bool FFX::outputConstraints(const elm::String& function_name, const elm::String& lp_filename)
+{
+	io::OutFileStream LPStream(lp_filename);
+	if(!LPStream.isReady())
+		return false;
+	io::Output LPFile(LPStream);
+	sanitizeCallReturns();
+
+	Vector<elm::String> vars; // edge id -> variable
+	Vector<t::uint32> sources; // edge id -> source address
+	HashTable<elm::String, int> var_ids;
+	int constraint_count = 0;
+
+	LPFile << "/* pathfinder " << function_name << " " << __DATE__ << ": infeasible path constraints */" << endl;
+	LPFile << "/* e_<src>_<dst>: execution count of the edge between the blocks at addresses src and dst */" << endl;
+	LPFile << "/* n_<f>: execution count of the function at address f */" << endl;
+	Vector<CFG*> funs;
+	for(Vector<DetailedPath>::Iter iter(infeasible_paths); iter; iter++)
+		if(!funs.contains(iter->function()))
+			funs.push(iter->function());
+	for(Vector<CFG*>::Iter f(funs); f; f++)
+	{
+		const elm::String count_var = _ << "n_" << io::hex(f->address().offset());
+
+		// paths as sets of edges, without duplicates
+		Vector<Vector<int> > paths;
+		HashTable<elm::String, bool> known;
+		int path_count = 0, not_encoded = 0, duplicates = 0, max_length = 0;
+		for(Vector<DetailedPath>::Iter iter(infeasible_paths); iter; iter++)
+		{
+			if(iter->function() != *f || !checkPathValidity(*iter, false))
+				continue;
+			path_count++;
+			bool flat = true;
+			for(DetailedPath::Iterator fi(*iter); fi && flat; fi++)
+				if(fi->isEdge() && (inLoop(fi->getEdge()->source()) || inLoop(fi->getEdge()->target())))
+					flat = false;
+			Vector<Element> elems;
+			if(flat)
+				elementsOf(*iter, elems);
+			Vector<int> edges;
+			for(Vector<Element>::Iter e(elems); e && flat; e++)
+			{
+				if(e->kind == Element::EDGE)
+				{
+					const elm::String var = _ << "e_" << io::hex(e->a.offset()) << "_" << io::hex(e->b.offset());
+					if(!var_ids.hasKey(var))
+					{
+						var_ids.put(var, vars.length());
+						vars.push(var);
+						sources.push(e->a.offset());
+					}
+					insertSorted(edges, var_ids.get(var, -1));
+				}
+				else if(e->kind != Element::COMMENT)
+					flat = false;
+			}
+			if(!flat)
+				not_encoded++;
+			else if(edges.isEmpty())
+				continue;
+			else if(known.hasKey(keyOf(edges)))
+				duplicates++;
+			else
+			{
+				known.put(keyOf(edges), true);
+				paths.push(edges);
+				if(edges.length() > max_length)
+					max_length = edges.length();
+			}
+		}
+
+		// drop paths containing a shorter path: shortest first, each kept path is indexed by its edges,
+		// and K is contained in P if P's edges reach K |K| times
+		Vector<Vector<int> > kept;
+		HashTable<int, Vector<int>*> containing; // edge id -> kept paths
+		for(int length = 1; length <= max_length; length++)
+			for(int i = 0; i < paths.length(); i++)
 			{
-				if(caller_q.last() != iter->getEdge()->source()->cfg())
+				if(paths[i].length() != length)
+					continue;
+				HashTable<int, int> hits;
+				bool implied = false;
+				for(int j = 0; j < length && !implied; j++)
 				{
-					CFG* cfg = iter->getEdge()->source()->cfg();
-					ASSERT(caller_q.contains(cfg));
-					while(caller_q.last() != cfg) // TODO! hax
+					const Vector<int>* ks = containing.get(paths[i][j], NULL);
+					for(int k = 0; ks && k < ks->length() && !implied; k++)
 					{
-						DBG("added missing return edge of " << caller_q.last() << " : " << callers.last())
-						infeasible_paths[ip].addBefore(iter, DetailedPath::FlowInfo(DetailedPath::FlowInfo::KIND_RETURN, callers.last()));
-						caller_q.pop();
-						callers.pop();
+						const int n = hits.get((*ks)[k], 0) + 1;
+						hits.put((*ks)[k], n);
+						implied = n == kept[(*ks)[k]].length();
 					}
 				}
-				// ASSERTP(false, "edge doesn't match queue, queue is " << caller_q << "," << endl << 
-					// << caller_q.last() << " =/= " << iter->getEdge()->source()->cfg() << ", ip=" << *ip)
+				if(implied)
+					continue;
+				for(int j = 0; j < length; j++)
+					addToIndex(containing, paths[i][j], kept.length());
+				kept.push(paths[i]);
+			}
+		freeIndex(containing);
+
+		// group paths R+a, R+b... where a, b... leave the same block
+		HashTable<elm::String, Vector<int>*> groups;
+		for(int i = 0; i < kept.length(); i++)
+			for(int j = 0; j < kept[i].length(); j++)
+				addToIndex(groups, groupKey(kept[i], j, sources), i);
+		Vector<bool> done(kept.length());
+		for(int i = 0; i < kept.length(); i++)
+			done.push(false);
+		int merged = 0, merged_into = 0;
+		StringBuffer body;
+		for(int i = 0; i < kept.length(); i++)
+		{
+			if(done[i])
+				continue;
+			// the largest group of i's alternatives still available
+			Vector<int> best;
+			int best_edge = -1;
+			for(int j = 0; j < kept[i].length(); j++)
+			{
+				const Vector<int>* members = groups.get(groupKey(kept[i], j, sources), NULL);
+				Vector<int> available;
+				for(int m = 0; members && m < members->length(); m++)
+					if(!done[(*members)[m]])
+						available.push((*members)[m]);
+				if(available.length() > best.length())
+				{
+					best = available;
+					best_edge = j;
+				}
 			}
-			else if(iter->isCall())
+			body << "ip" << constraint_count++ << ": ";
+			int bound;
+			if(best.length() >= 2)
 			{
-				caller_q.push(iter->getCaller()->callee());
-				callers.push(iter->getCaller());
+				// the common part, then the edge each path adds to it
+				Vector<int> common = kept[i];
+				common.removeAt(best_edge);
+				for(int k = 0; k < common.length(); k++)
+					body << (k ? " + " : "") << vars[common[k]];
+				for(int m = 0; m < best.length(); m++)
+				{
+					for(int k = 0; k < kept[best[m]].length(); k++)
+						if(!common.contains(kept[best[m]][k]))
+							body << (common.length() || m ? " + " : "") << vars[kept[best[m]][k]];
+					done[best[m]] = true;
+				}
+				bound = common.length();
+				merged += best.length();
+				merged_into++;
 			}
-			else if(iter->isReturn())
+			else
 			{
-				ASSERT(caller_q.last() == iter->getCaller()->callee())
-				caller_q.pop();
-				callers.pop();
+				for(int k = 0; k < kept[i].length(); k++)
+					body << (k ? " + " : "") << vars[kept[i][k]];
+				bound = kept[i].length() - 1;
+				done[i] = true;
 			}
+			if(bound)
+				body << " - " << bound << " " << count_var;
+			body << " <= 0;\n";
 		}
+		freeIndex(groups);
+		LPFile << endl << "/* " << f->name() << ": " << path_count << " paths, " << (duplicates + paths.length() - kept.length()) << " duplicated or implied, "
+			<< merged << " merged into " << merged_into << " constraints, " << not_encoded << " in loop or call contexts not encoded */" << endl;
+		LPFile << body.toString();
 	}
+	if(dbg_verbose < DBG_VERBOSE_NONE)
+		cout << "constraints output to " + lp_filename << endl;
+	return true;
+}
+
+void FFX::sanitizeCallReturns(void)
+{
+	for(int i = 0; i < infeasible_paths.count(); i++)
+		sanitizeCallReturns(infeasible_paths[i]);
+}
+
+void FFX::sanitizeCallReturns(DetailedPath& ip)
+{
+	Vector<CFG*> caller_q;
+	Vector<Option<SynthBlock*> > callers;
+		caller_q.push(ip.function());
+		callers.push(elm::none);
+	for(DetailedPath::Iterator iter(ip); iter; iter++)
+	{
+		if(iter->isEdge())
+		{
+			if(caller_q.last() != iter->getEdge()->source()->cfg())
+			{
+				CFG* cfg = iter->getEdge()->source()->cfg();
+				ASSERT(caller_q.contains(cfg));
+				while(caller_q.last() != cfg) // TODO! hax
+				{
+					DBG("added missing return edge of " << caller_q.last() << " : " << callers.last())
+					ip.addBefore(iter, DetailedPath::FlowInfo(DetailedPath::FlowInfo::KIND_RETURN, callers.last()));
+					caller_q.pop();
+					callers.pop();
+				}
+			}
+			// ASSERTP(false, "edge doesn't match queue, queue is " << caller_q << "," << endl << 
+				// << caller_q.last() << " =/= " << iter->getEdge()->source()->cfg() << ", ip=" << *ip)
+		}
+		else if(iter->isCall())
+		{
+			caller_q.push(iter->getCaller()->callee());
+			callers.push(iter->getCaller());
+		}
+		else if(iter->isReturn())
+		{
+			ASSERT(caller_q.last() == iter->getCaller()->callee())
+			caller_q.pop();
+			callers.pop();
+		}
+	}
+}
+
+/**
+ * @fn bool FFX::open(const elm::String& function_name, const elm::String& ffx_filename);
+ * @brief Start streaming infeasible paths to a FFX file. The file is kept well-formed after each path,
+ * and an index of the paths (offset, length, function, edge count) is written to ffx_filename.idx.
+ * @return false if the file could not be created
+ */
+bool FFX::open(const elm::String& function_name, const elm::String& ffx_filename)
+{
+	close();
+	fd = ::open(ffx_filename.toCString(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return false;
+	index_fd = ::open((_ << ffx_filename << ".idx").toCString(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	end = 0;
+	streamed_function = NULL;
+	indent_level = 0;
+	return append(_ << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+		<< "<flowfacts> <!-- pathfinder " << function_name << " " << __DATE__ << ", streamed -->\n");
+}
+
+/**
+ * @fn void FFX::stream(const DetailedPath& ip);
+ * @brief Append an infeasible path to the streamed file, if it is valid
+ */
+void FFX::stream(const DetailedPath& ip)
+{
+	if(fd < 0)
+		return;
+	DetailedPath sanitized(ip);
+	sanitizeCallReturns(sanitized);
+	if(!checkPathValidity(sanitized, false))
+		return;
+	io::BlockOutStream buf;
+	io::Output out(buf);
+	if(sanitized.function() != streamed_function)
+	{
+		if(streamed_function)
+			out << indent(-1) << "</function>" << endl;
+		out << indent(  ) << "<function name=\"" << sanitized.function()->name() << "\">" << endl; indent(+1);
+		streamed_function = sanitized.function();
+	}
+	out.flush();
+	const int start = buf.size();
+	printInfeasiblePath(out, sanitized);
+	out.flush();
+	const t::uint64 offset = end + start;
+	const int length = buf.size() - start;
+	if(append(buf.toString()) && index_fd >= 0)
+	{
+		const elm::String line = _ << offset << "\t" << length << "\t" << sanitized.function()->name() << "\t" << sanitized.countEdges() << "\n";
+		if(::write(index_fd, line.chars(), line.length()) != ssize_t(line.length()))
+			DBGG("Could not write the index of the streamed infeasible paths")
+	}
+}
+
+/**
+ * @fn void FFX::close();
+ * @brief Stop streaming. The closing tags are already in the file.
+ */
+void FFX::close()
+{
+	if(fd >= 0)
+		::close(fd);
+	if(index_fd >= 0)
+		::close(index_fd);
+	fd = index_fd = -1;
+}
+
+// write body after the streamed paths, followed by the closing tags of what is open
+bool FFX::append(const elm::String& body)
+{
+	const elm::String trailer = streamed_function ? "</function>\n</flowfacts>\n" : "</flowfacts>\n";
+	const elm::String s = _ << body << trailer;
+	if(::pwrite(fd, s.chars(), s.length(), off_t(end)) != ssize_t(s.length()))
+		return false;
+	end += body.length();
+	return ::ftruncate(fd, off_t(end + trailer.length())) == 0; // the previous trailer may have been longer
 }
 
 void FFX::outputSortedInfeasiblePaths(io::Output& FFXFile)
@@ -144,11 +640,64 @@ void FFX::outputSortedInfeasiblePaths(io::Output& FFXFile)
  * @param ip path to print
  */
 void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
+{
+	Vector<Element> elems;
+	elementsOf(ip, elems);
+	FFXFile	<< indent(  ) << "<not-all seq=\"true\">" << endl; indent(+1);
+	for(Vector<Element>::Iter e(elems); e; e++)
+		switch(e->kind)
+		{
+			case Element::EDGE:
+				FFXFile << indent(  ) << "<edge src=\"0x" << e->a << "\" dst=\"0x" << e->b << "\" /> <!-- " << e->comment << " -->" << endl;
+				break;
+			case Element::LOOP:
+				FFXFile << indent(  ) << "<loop address=\"0x" << e->a << "\">" << " <!-- " << e->comment << " -->" << endl;
+				FFXFile << indent(  ) << "<iteration number=\"" << (e->all_iterations ? "*" : "n") << "\">" << endl;
+				indent(+1);
+				break;
+			case Element::END_LOOP:
+				FFXFile << indent(-1) << "</iteration>" << endl;
+				if(!e->comment.isEmpty())
+					FFXFile << indent(  ) << "</loop> <!-- " << e->comment << "-->" << endl;
+				else
+					FFXFile << indent(  ) << "</loop>" << endl;
+				break;
+			case Element::CALL:
+				FFXFile << indent( ) << "<call address=\"0x" << e->a << "\" name=\"" << e->name << "\">" " <!-- " << e->comment << " -->" << endl;
+				// also open a function tag
+				FFXFile << indent( ) << "<function address=\"0x" << e->b << "\" name=\"" << e->name << "\">"
+					<< endl; indent(+1);
+				break;
+			case Element::RETURN:
+				if(e->at_end)
+				{
+					FFXFile << indent(-1) << "</function>" << endl; // also close function
+					FFXFile << indent(  ) << "</call>" << endl;
+				}
+				else
+				{
+					FFXFile << indent(  ) << "</function>" << endl; // alo close function
+					FFXFile << indent(-1) << "</call>" " <!-- " << e->comment << " -->" << endl;
+				}
+				break;
+			case Element::COMMENT:
+				FFXFile << indent(  ) << "<!-- " << e->comment << " -->" << endl;
+				break;
+		}
+	FFXFile << indent(-1) << "</not-all>" << endl;
+}
+
+/**
+ * @fn void FFX::elementsOf(const DetailedPath& ip, Vector<Element>& elems);
+ * @brief Translate an infeasible path into the elements of its flow fact (edges between basic blocks, loops and calls)
+ * @param ip path to translate
+ * @param elems where to add the elements
+ */
+void FFX::elementsOf(const DetailedPath& ip, Vector<Element>& elems)
 {
 	SLList<ffx_tag_t> open_tags;
 	SLList<Block*> caller_q;
 	// int active_loops = 0, active_calls = 0;
-	FFXFile	<< indent(  ) << "<not-all seq=\"true\">" << endl; indent(+1);
 	for(DetailedPath::Iterator iter(ip); iter; iter++)
 	{
 		if(iter->isEdge())
@@ -182,7 +731,7 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 				if(!includes_edge_in_subCFG)
 					ASSERTP(false, "ERROR: infeasible path includes return edge of sub-CFG" << subcfg->name()
 						<< ", but no edge from that CFG! ip=" << ip)
-				FFXFile << indent(  ) << "<!-- skipped return edge of " << subcfg->name() << " -->" << endl;
+				elems.push(Element(Element::COMMENT, Address::null, Address::null, _ << "skipped return edge of " << subcfg->name()));
 				continue;
 			}
 			else if(e->source()->isExit())
@@ -207,7 +756,7 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 				ASSERT(e->target()->isCall()) // otherwise would be virtual...
 				if(nextElementisCall(iter, e->target()->toSynth()->callee()))
 				{
-					FFXFile << indent(  ) << "<!-- skipped call edge of " << e->target()->toSynth()->callee()->name() << " -->" << endl;
+					elems.push(Element(Element::COMMENT, Address::null, Address::null, _ << "skipped call edge of " << e->target()->toSynth()->callee()->name()));
 					continue;
 				}
 				cerr << "WARNING: found a call edge (" << e->source() << "->" << e->target() << ") not followed by a call element. end of path=" << !bool(iter) << endl;
@@ -220,10 +769,10 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 			{
 				#if 0 // This doesn't work because there are multiple exit edges and they are meaningful in an infeasible path
 					// TODO: make sure this doesn't make problems with empty <call></call>. function MUST be called even though we remove this edge
-					FFXFile << indent(  ) << "<!-- skipped exit edge of " << e->target()->cfg()->name() << " -->" << endl;
+					elems.push(Element(Element::COMMENT, Address::null, Address::null, _ << "skipped exit edge of " << e->target()->cfg()->name()));
 					continue;
 				#endif
-				FFXFile << indent(  ) << "<!-- adding virtual exit edge of " << e->target()->cfg()->name() << " -->" << endl;
+				elems.push(Element(Element::COMMENT, Address::null, Address::null, _ << "adding virtual exit edge of " << e->target()->cfg()->name()));
 
 				// make sure the caller we found is in CallerIter
 				Block *caller = NULL;
@@ -258,23 +807,15 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 				*/
 			}
 
-			FFXFile << indent(  ) << "<edge src=\"0x" << source->address() << "\" dst=\"0x" << target->address()
-					<< "\" /> <!-- " << (Block*)source << " -> " << (Block*)target << " -->" << endl;
-
+			elems.push(Element(Element::EDGE, source->address(), target->address(), _ << (Block*)source << " -> " << (Block*)target));
 		}
 		else if(iter->isLoopEntry())
 		{
 			BasicBlock* loop_header = iter->getLoopHeader();
-			FFXFile << indent(  ) << "<loop address=\"0x" << loop_header->address() << "\">"
-					<< " <!-- loop " << loop_header->index() << " -->" << endl; //indent(+1);
-			if(edgeAfter(ip.find(DetailedPath::FlowInfo(DetailedPath::FlowInfo::KIND_LOOP_EXIT, loop_header)))) {
-				FFXFile << indent(  ) << "<iteration number=\"n\">" << endl;
-				indent(+1);
-			}
-			else {
-				FFXFile << indent(  ) << "<iteration number=\"*\">" << endl;
-				indent(+1);
-			}
+			Element loop(Element::LOOP, loop_header->address(), Address::null, _ << "loop " << loop_header->index());
+			// without a loop exit followed by an edge, the path spans all the iterations
+			loop.all_iterations = !edgeAfter(ip.find(DetailedPath::FlowInfo(DetailedPath::FlowInfo::KIND_LOOP_EXIT, loop_header)));
+			elems.push(loop);
 			open_tags += FFX_TAG_LOOP;
 		}
 		else if(iter->isLoopExit())
@@ -283,11 +824,10 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 				ASSERTP(false,"WARNING: </loop> found when no context is open") // TODO! we should fix this LEx that doesn't have a previous LEn, that's a bug...
 			}
 			ASSERTP(open_tags.first() == FFX_TAG_LOOP, "</loop> found when not directly in loop context");
-			FFXFile << indent(-1) << "</iteration>" << endl;
 			if(const BasicBlock* loop_header = iter->getLoopHeader()) // if not NULL, we have info
-				FFXFile << indent(  ) << "</loop> <!-- loop " << loop_header->index() << "-->" << endl;
+				elems.push(Element(Element::END_LOOP, Address::null, Address::null, _ << "loop " << loop_header->index()));
 			else
-				FFXFile << indent(  ) << "</loop>" << endl;
+				elems.push(Element(Element::END_LOOP));
 			open_tags.removeFirst();
 		}
 		else if(iter->isCall())
@@ -295,20 +835,17 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 			SynthBlock* caller = iter->getCaller();
 			caller_q += caller;
 			BasicBlock* callpoint = theOnly(caller->ins())->source()->toBasic(); // TODO add asserts
-			FFXFile << indent( ) << "<call address=\"0x" << callpoint->control()->address() << "\" name=\"" << caller->callee()->name() << "\">"
-				" <!-- call " << caller->cfg() << ":" << caller->index() << " -> " << caller->callee() << " -->" << endl;
-			// also open a function tag
-			FFXFile << indent( ) << "<function address=\"0x" << caller->callee()->address() << "\" name=\"" << caller->callee()->name() << "\">"
-				<< endl; indent(+1);
+			Element call(Element::CALL, callpoint->control()->address(), caller->callee()->address(),
+				_ << "call " << caller->cfg() << ":" << caller->index() << " -> " << caller->callee());
+			call.name = caller->callee()->name();
+			elems.push(call);
 			open_tags += FFX_TAG_CALL;
 		}
 		else if(iter->isReturn())
 		{
 			const SynthBlock* caller = iter->getCaller();
 			caller_q.removeFirst();
-			FFXFile << indent(  ) << "</function>" << endl; // alo close function
-			FFXFile << indent(-1) << "</call>"
-				" <!-- return " << caller->cfg() << ":" << caller->index() << " <- " << caller->callee() << " -->" << endl;
+			elems.push(Element(Element::RETURN, Address::null, Address::null, _ << "return " << caller->cfg() << ":" << caller->index() << " <- " << caller->callee()));
 			ASSERTP(open_tags.first() == FFX_TAG_CALL, "return found when call is not the most recent open tag")
 			open_tags.removeFirst();
 		}
@@ -317,17 +854,9 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 	// close running <loop ... > environments
 	for(SLList<ffx_tag_t>::Iterator open_tags_iter(open_tags); !open_tags_iter.ended(); open_tags_iter++)
 	{
-		switch(*open_tags_iter)
-		{
-			case FFX_TAG_LOOP:
-				FFXFile << indent(-1) << "</iteration>" << endl;
-				FFXFile << indent(  ) << "</loop>" << endl;
-				break;
-			case FFX_TAG_CALL:
-				FFXFile << indent(-1) << "</function>" << endl; // also close function
-				FFXFile << indent(  ) << "</call>" << endl;
-				break;
-		}
+		Element closing(*open_tags_iter == FFX_TAG_LOOP ? Element::END_LOOP : Element::RETURN);
+		closing.at_end = true;
+		elems.push(closing);
 	}
 	/*for( ; active_loops > 0; active_loops--)
 	{
@@ -336,7 +865,6 @@ void FFX::printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip)
 	}
 	for( ; active_calls > 0; active_calls--)
 		FFXFile << indent(-1) << "</call>" << endl;*/
-	FFXFile << indent(-1) << "</not-all>" << endl;
 }
 
 /**
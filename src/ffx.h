@@ -30,8 +30,16 @@
 class FFX
 {
 public:
-	FFX(const Vector<DetailedPath>& ips);
+	FFX(const Vector<DetailedPath>& ips = Vector<DetailedPath>());
+	~FFX();
 	void output(const elm::String& filename, const elm::String& function_name, const elm::String& graph_filename = "");
+	bool outputBinary(const elm::String& function_name, const elm::String& ipb_filename);
+	bool outputConstraints(const elm::String& function_name, const elm::String& lp_filename);
+
+	// streaming output, one path at a time
+	bool open(const elm::String& function_name, const elm::String& ffx_filename);
+	void stream(const DetailedPath& ip);
+	void close();
 
 private:
 	typedef enum
@@ -40,9 +48,26 @@ private:
 		FFX_TAG_CALL=1,
 	} ffx_tag_t;
 
+	// element of the flow fact of a path, printed as XML or encoded in binary
+	class Element {
+	public:
+		typedef enum { EDGE, LOOP, END_LOOP, CALL, RETURN, COMMENT } kind_t;
+		inline Element(kind_t kind = COMMENT, Address a = Address::null, Address b = Address::null, const elm::String& comment = "")
+			: kind(kind), a(a), b(b), comment(comment), all_iterations(false), at_end(false) { }
+		kind_t kind;
+		Address a, b; // EDGE: source and target, LOOP: header, CALL: call point and callee
+		elm::String name; // CALL: callee
+		elm::String comment;
+		bool all_iterations; // LOOP: iteration="*" instead of "n"
+		bool at_end; // END_LOOP, RETURN: closes what is still open at the end of the path
+	};
+
 	void sanitizeCallReturns(void);
+	static void sanitizeCallReturns(DetailedPath& ip);
+	bool append(const elm::String& body);
 	void outputSortedInfeasiblePaths(io::Output& FFXFile);
 	void printInfeasiblePath(io::Output& FFXFile, const DetailedPath& ip);
+	void elementsOf(const DetailedPath& ip, Vector<Element>& elems);
 	void writeGraph(io::Output& GFile, const Vector<DetailedPath>& ips);
 	bool checkPathValidity(const DetailedPath& ip, bool critical) const;
 	static bool lastIsCaller(SLList<ffx_tag_t> open_tags);
@@ -55,6 +80,9 @@ private:
 
 	Vector<DetailedPath> infeasible_paths;
 	int indent_level;
+	int fd, index_fd; // streamed FFX file and its index
+	t::uint64 end; // end of the streamed paths, followed by the closing tags
+	CFG* streamed_function; // function whose tag is open in the streamed file
 };
 
 #endif
@@ -0,0 +1,215 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _IPB_H
+#define _IPB_H
+
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Compact binary format of the infeasible paths (.ipb), written by pathfinder --ob.
+ * Only depends on the C library, so that tools reading the paths do not need OTAWA.
+ *
+ * The file is made of little-endian 32-bit words, whatever the byte order of the host that wrote it, so that it can be mapped
+ * and read in place (words are decoded from their bytes, which costs nothing on little-endian hosts):
+ *	header			see ipb::header_t
+ *	addresses		address_count addresses
+ *	edges			edge_count pairs (source, target) of address indices
+ *	calls			call_count triples (call point, callee) address indices and callee name
+ *	paths			path_count offsets (in words, from the start of the file) of the path records
+ *	path records	function name, token count n, then n tokens
+ *	strings			string_size bytes of NUL-terminated strings, names are byte offsets in there
+ * A token has its kind in its 3 low bits and its operand in the other bits: EDGE (edge index), LOOP_N or LOOP_ALL
+ * (address index of the loop header, iteration "n" or "*" in FFX), END_LOOP, CALL (call index), RETURN.
+ * Paths are grouped by function, in the order of the FFX output.
+ */
+namespace ipb {
+
+static const uint32_t MAGIC = 0x50494650; // "PFIP"
+static const uint32_t VERSION = 2;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304; // reads as 0x04030201 if the file was written in the wrong byte order
+
+typedef enum {
+	EDGE		= 0,
+	LOOP_N		= 1,
+	LOOP_ALL	= 2,
+	END_LOOP	= 3,
+	CALL		= 4,
+	RETURN		= 5,
+} kind_t;
+
+inline uint32_t token(kind_t kind, uint32_t operand = 0) { return (operand << 3) | kind; }
+inline kind_t kind(uint32_t token) { return kind_t(token & 7); }
+inline uint32_t operand(uint32_t token) { return token >> 3; }
+
+typedef struct {
+	uint32_t magic, version, byte_order;
+	uint32_t entry; // name of the analyzed function
+	uint32_t address_count, edge_count, call_count, path_count, string_size;
+	uint32_t addresses, edges, calls, paths; // offsets, in words
+	uint32_t strings; // offset, in bytes
+} header_t;
+
+// Read-only view of a .ipb file, checked once when opened
+class Reader
+{
+public:
+	class Path {
+	public:
+		inline Path(const Reader& r, uint32_t p) : r(r), p(p) { }
+		inline const char* function() const { return r.string(r.word(p)); }
+		inline uint32_t count() const { return r.word(p + 1); }
+		inline uint32_t operator[](uint32_t i) const { return r.word(p + 2 + i); }
+	private:
+		const Reader& r;
+		uint32_t p; // offset of the record, in words
+	};
+
+	inline Reader() : w(NULL), size(0), mapped(false) { memset(&h, 0, sizeof(h)); }
+	inline ~Reader() { close(); }
+
+	// map a file
+	bool open(const char* path)
+	{
+		close();
+		const int fd = ::open(path, O_RDONLY);
+		if(fd < 0)
+			return false;
+		struct stat st;
+		void* data = MAP_FAILED;
+		if(fstat(fd, &st) == 0 && st.st_size > 0)
+			data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if(data == MAP_FAILED)
+			return false;
+		if(!attach(data, st.st_size))
+		{
+			munmap(data, st.st_size);
+			return false;
+		}
+		mapped = true;
+		return true;
+	}
+
+	// use a file already in memory (4-byte aligned), which must outlive the reader
+	bool attach(const void* data, size_t data_size)
+	{
+		close();
+		w = static_cast<const uint32_t*>(data);
+		size = data_size;
+		if(size >= sizeof(header_t)) // decoded once
+			for(size_t i = 0; i < sizeof(header_t) / 4; i++)
+				reinterpret_cast<uint32_t*>(&h)[i] = word(i);
+		if(!check())
+		{
+			w = NULL;
+			size = 0;
+			return false;
+		}
+		return true;
+	}
+
+	void close()
+	{
+		if(mapped)
+			munmap(const_cast<uint32_t*>(w), size);
+		w = NULL;
+		size = 0;
+		mapped = false;
+	}
+
+	inline const header_t& header() const { return h; }
+	inline uint32_t pathCount() const { return h.path_count; }
+	inline Path path(uint32_t i) const { return Path(*this, word(h.paths + i)); }
+	inline const char* entry() const { return string(h.entry); }
+	inline uint32_t address(uint32_t i) const { return word(h.addresses + i); }
+	inline uint32_t edgeSource(uint32_t e) const { return address(word(h.edges + 2*e)); }
+	inline uint32_t edgeTarget(uint32_t e) const { return address(word(h.edges + 2*e + 1)); }
+	inline uint32_t callPoint(uint32_t c) const { return address(word(h.calls + 3*c)); }
+	inline uint32_t callee(uint32_t c) const { return address(word(h.calls + 3*c + 1)); }
+	inline const char* calleeName(uint32_t c) const { return string(word(h.calls + 3*c + 2)); }
+	inline const char* string(uint32_t offset) const { return reinterpret_cast<const char*>(w) + h.strings + offset; }
+
+	// word i of the file, stored little-endian
+	inline uint32_t word(size_t i) const
+	{
+		const unsigned char* b = reinterpret_cast<const unsigned char*>(w + i);
+		return uint32_t(b[0]) | uint32_t(b[1]) << 8 | uint32_t(b[2]) << 16 | uint32_t(b[3]) << 24;
+	}
+
+private:
+	// check everything once, so that the accessors do not have to
+	bool check() const
+	{
+		const size_t words = size / 4;
+		if(words < sizeof(header_t) / 4)
+			return false;
+		if(h.magic != MAGIC || h.version != VERSION || h.byte_order != BYTE_ORDER_MARK)
+			return false;
+		if(!within(h.addresses, h.address_count, words) || !within(h.edges, 2 * uint64_t(h.edge_count), words)
+		|| !within(h.calls, 3 * uint64_t(h.call_count), words) || !within(h.paths, h.path_count, words)
+		|| h.strings % 4 || uint64_t(h.strings) + h.string_size > size || !validString(h.entry))
+			return false;
+		for(uint32_t i = 0; i < 2 * h.edge_count; i++)
+			if(word(h.edges + i) >= h.address_count)
+				return false;
+		for(uint32_t c = 0; c < h.call_count; c++)
+			if(word(h.calls + 3*c) >= h.address_count || word(h.calls + 3*c + 1) >= h.address_count || !validString(word(h.calls + 3*c + 2)))
+				return false;
+		for(uint32_t i = 0; i < h.path_count; i++)
+		{
+			const uint32_t p = word(h.paths + i);
+			if(!within(p, 2, words) || !within(uint64_t(p) + 2, word(p + 1), words) || !validString(word(p)))
+				return false;
+			for(uint32_t t = 0; t < word(p + 1); t++)
+			{
+				const uint32_t tok = word(p + 2 + t);
+				switch(kind(tok))
+				{
+					case EDGE: if(operand(tok) >= h.edge_count) return false; break;
+					case LOOP_N: case LOOP_ALL: if(operand(tok) >= h.address_count) return false; break;
+					case CALL: if(operand(tok) >= h.call_count) return false; break;
+					case END_LOOP: case RETURN: break;
+					default: return false;
+				}
+			}
+		}
+		return true;
+	}
+	static inline bool within(uint64_t offset, uint64_t count, uint64_t words) { return offset + count <= words; }
+	inline bool validString(uint32_t offset) const
+		{ return offset < h.string_size && memchr(string(offset), '\0', h.string_size - offset); }
+
+	const uint32_t* w;
+	size_t size;
+	bool mapped;
+	header_t h; // decoded
+};
+
+} // ipb
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+/*
+ * ipb2ffx: convert the binary infeasible paths of pathfinder (.ipb) to FFX
+ * usage: ipb2ffx <file.ipb> [<file.ffx>]
+ */
+
+#include <cstdio>
+#include "ipb.h"
+
+static void indent(FILE* out, int level)
+{
+	for(int i = 0; i < level; i++)
+		fputc('\t', out);
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "usage: %s <file.ipb> [<file.ffx>]\n", argv[0]);
+		return 2;
+	}
+	ipb::Reader r;
+	if(!r.open(argv[1]))
+	{
+		fprintf(stderr, "%s: cannot read, or not a valid .ipb file\n", argv[1]);
+		return 1;
+	}
+	FILE* out = argc == 3 ? fopen(argv[2], "w") : stdout;
+	if(!out)
+	{
+		perror(argv[2]);
+		return 1;
+	}
+
+	fprintf(out, "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n");
+	fprintf(out, "<flowfacts> <!-- pathfinder %s, from %s -->\n", r.entry(), argv[1]);
+	const char* function = NULL;
+	for(uint32_t i = 0; i < r.pathCount(); i++)
+	{
+		const ipb::Reader::Path p = r.path(i);
+		if(!function || strcmp(function, p.function()) != 0)
+		{
+			if(function)
+				fprintf(out, "</function>\n");
+			function = p.function();
+			fprintf(out, "<function name=\"%s\">\n", function);
+		}
+		int level = 1;
+		indent(out, level++);
+		fprintf(out, "<not-all seq=\"true\">\n");
+		for(uint32_t t = 0; t < p.count(); t++)
+		{
+			const uint32_t op = ipb::operand(p[t]);
+			switch(ipb::kind(p[t]))
+			{
+				case ipb::EDGE:
+					indent(out, level);
+					fprintf(out, "<edge src=\"0x%08x\" dst=\"0x%08x\" />\n", r.edgeSource(op), r.edgeTarget(op));
+					break;
+				case ipb::LOOP_N:
+				case ipb::LOOP_ALL:
+					indent(out, level);
+					fprintf(out, "<loop address=\"0x%08x\">\n", r.address(op));
+					indent(out, level++);
+					fprintf(out, "<iteration number=\"%s\">\n", ipb::kind(p[t]) == ipb::LOOP_N ? "n" : "*");
+					break;
+				case ipb::END_LOOP:
+					indent(out, --level);
+					fprintf(out, "</iteration>\n");
+					indent(out, level);
+					fprintf(out, "</loop>\n");
+					break;
+				case ipb::CALL:
+					indent(out, level);
+					fprintf(out, "<call address=\"0x%08x\" name=\"%s\">\n", r.callPoint(op), r.calleeName(op));
+					indent(out, level++);
+					fprintf(out, "<function address=\"0x%08x\" name=\"%s\">\n", r.callee(op), r.calleeName(op));
+					break;
+				case ipb::RETURN: // closed at the level they were opened at, like the loops
+					indent(out, --level);
+					fprintf(out, "</function>\n");
+					indent(out, level);
+					fprintf(out, "</call>\n");
+					break;
+			}
+		}
+		indent(out, 1);
+		fprintf(out, "</not-all>\n");
+	}
+	if(function)
+		fprintf(out, "</function>\n");
+	fprintf(out, "</flowfacts>\n");
+	if(out != stdout)
+		fclose(out);
+	return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <otawa/cfg/BasicBlock.h>
+#include "compiled_bb.h"
+#include "liveness.h"
+
+using namespace otawa::sem;
+
+Identifier<LockPtr<Liveness> > Liveness::ID("Registers live at the boundaries of the blocks of a CFG");
+elm::genstruct::SLList<CFG*> Liveness::computing;
+
+/**
+ * @class Liveness
+ * @brief Backward liveness of the registers of a CFG, on the semantic instructions.
+ * Everything is live at the exit of a CFG, and a call reads whatever its callee may read before writing it.
+ * A register is dead at a point when each path from there writes it before reading it, so its value can be dropped.
+ */
+Liveness::Liveness(CFG* cfg, int max_registers) : count(cfg->count()), entry(cfg->entry()->index())
+{
+	Block** blocks = new Block*[count];
+	BitVector *gen = new BitVector[count], *kill = new BitVector[count];
+	live_in = new BitVector[count];
+	live_out = new BitVector[count];
+	for(CFG::BlockIter b(cfg->blocks()); b; b++)
+	{
+		const int i = b->index();
+		blocks[i] = *b;
+		gen[i] = BitVector(max_registers, false);
+		kill[i] = BitVector(max_registers, false);
+		live_in[i] = BitVector(max_registers, false);
+		live_out[i] = BitVector(max_registers, false);
+		summarize(*b, gen[i], kill[i], max_registers);
+	}
+
+	// round-robin fixpoint, visiting blocks backwards
+	for(bool changed = true; changed; )
+	{
+		changed = false;
+		for(int i = count-1; i >= 0; i--)
+		{
+			BitVector out(max_registers, false);
+			for(Block::EdgeIter e(blocks[i]->outs()); e; e++)
+				out.applyOr(live_in[e->target()->index()]);
+			BitVector in(out);
+			in.applyReset(kill[i]);
+			in.applyOr(gen[i]);
+			live_out[i] = out;
+			if(!(in == live_in[i]))
+			{
+				live_in[i] = in;
+				changed = true;
+			}
+		}
+	}
+	delete[] blocks;
+	delete[] gen;
+	delete[] kill;
+}
+
+Liveness::~Liveness()
+{
+	delete[] live_in;
+	delete[] live_out;
+}
+
+/**
+ * @fn const Liveness& Liveness::of(CFG* cfg, int max_registers);
+ * @brief Get the liveness of the registers of a CFG, computing it (and the one of its callees) on the first call
+ */
+const Liveness& Liveness::of(CFG* cfg, int max_registers)
+{
+	if((*ID(cfg)).isNull())
+	{
+		computing.addFirst(cfg);
+		ID(cfg) = LockPtr<Liveness>(new Liveness(cfg, max_registers));
+		computing.removeFirst();
+	}
+	return **ID(cfg);
+}
+
+/**
+ * @brief Compute the registers read before being written (gen) and the registers always written (kill) by a block
+ */
+void Liveness::summarize(Block* b, BitVector& gen, BitVector& kill, int max_registers)
+{
+	if(b->isEntry())
+		return;
+	if(!b->isBasic())
+	{
+		CFG* callee = b->isCall() ? b->toSynth()->callee() : NULL;
+		if(callee && !computing.contains(callee))
+			gen = Liveness::of(callee, max_registers).liveIn();
+		else // exit, unknown target or recursive call: assume everything is read
+			for(int r = 0; r < max_registers; r++)
+				gen.set(r);
+		return;
+	}
+
+	#define USE(r) { elm::t::int16 _r = (r); if(_r >= 0 && _r < max_registers && !kill.bit(_r)) gen.set(_r); }
+	const CompiledBB& code = CompiledBB::of(b->toBasic());
+	for(int i = 0; i < code.countInsts(); i++)
+	{
+		bool in_conditional_segment = false;
+		elm::t::int16 sr = -1;
+		for(int k = code.firstStep(i); k < code.endStep(i); k++)
+		{
+			const inst& si = code.step(k).inst;
+			bool writes = true; // writes d
+			if(code.step(k).isCond())
+			{
+				in_conditional_segment = true;
+				sr = si.sr();
+			}
+			switch(si.op)
+			{
+				case NOP: case TRAP:
+					writes = false;
+					break;
+				case SCRATCH: case SETI: case SETP: case SPEC:
+					break;
+				case BRANCH:
+					USE(si.d())
+					writes = false;
+					break;
+				case IF: case ASSUME:
+					USE(si.sr())
+					writes = false;
+					break;
+				case CONT:
+					USE(sr)
+					writes = false;
+					break;
+				case LOAD:
+					USE(si.addr())
+					break;
+				case STORE:
+					USE(si.addr())
+					USE(si.reg())
+					writes = false;
+					break;
+				case SET: case NOT:
+					USE(si.a())
+					break;
+				default: // d <- f(a, b), and NEG which is read as a function of b
+					USE(si.a())
+					USE(si.b())
+					break;
+			}
+			// the writes of a conditional segment may not happen
+			if(writes && !in_conditional_segment && si.d() >= 0 && si.d() < max_registers)
+				kill.set(si.d());
+		}
+	}
+	#undef USE
+}
@@ -0,0 +1,59 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _LIVENESS_H
+#define _LIVENESS_H
+
+#include <elm/genstruct/SLList.h>
+#include <elm/util/BitVector.h>
+#include <elm/util/LockPtr.h>
+#include <otawa/cfg/CFG.h>
+#include <otawa/prop/Identifier.h>
+
+using elm::BitVector;
+using elm::LockPtr;
+using otawa::Block;
+using otawa::CFG;
+using otawa::Identifier;
+
+// Registers live at the boundaries of the blocks of a CFG, computed backwards on the semantic instructions
+class Liveness : public elm::Lock
+{
+public:
+	static const Liveness& of(CFG* cfg, int max_registers);
+
+	inline const BitVector& liveIn() const { return live_in[entry]; }
+	inline const BitVector& liveIn(Block* b) const { return live_in[b->index()]; }
+	inline const BitVector& liveOut(Block* b) const { return live_out[b->index()]; }
+
+	~Liveness();
+
+private:
+	Liveness(CFG* cfg, int max_registers);
+	void summarize(Block* b, BitVector& gen, BitVector& kill, int max_registers);
+
+	static Identifier<LockPtr<Liveness> > ID;
+	static elm::genstruct::SLList<CFG*> computing; // CFGs on the stack, for recursive calls
+	int count, entry;
+	BitVector *live_in, *live_out;
+};
+
+#endif
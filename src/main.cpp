@@ -22,15 +22,23 @@
 #include <elm/io/Output.h>
 #include <elm/types.h>
 #include <elm/options.h>
+#include <sys/time.h>
+#include <unistd.h> // _exit, unlink
 #include <otawa/cfg/features.h> // COLLECTED_CFG_FEATURE
+#include <otawa/dfa/State.h> // INITIAL_STATE_FEATURE
+#include <otawa/prog/Manager.h>
 #include <otawa/prog/WorkSpace.h>
 #include <otawa/app/Application.h>
 #include "v1/analysis1.h"
 #include "v2/analysis2.h"
+#include "batch.h"
 #include "debug.h"
 #include "ffx.h"
 #include "features.h"
 #include "oracle.h"
+#include "server.h"
+#include "telemetry.h"
+#include "trace.h"
 
 using namespace otawa;
 using namespace option;
@@ -52,6 +60,10 @@ public:
 		opt_noipresults	 (SwitchOption::Make(*this).cmd("--nir").cmd("--no-ip-results").description("do not print the list of IPs found")),
 		opt_detailedstats(SwitchOption::Make(*this).cmd("--ds").cmd("--detailed-stats").description("display detailed stats, including average length of infeasible_paths found")),
 		opt_graph_output (SwitchOption::Make(*this).cmd("-g").cmd("--graph-output").description("also output as a gnuplot .tsv graph file (requires -o)")),
+		opt_binary_output(SwitchOption::Make(*this).cmd("--ob").cmd("--output-binary").description("also output as a compact binary .ipb file, see src/ipb/ipb.h (requires -o)")),
+		opt_telemetry	 (SwitchOption::Make(*this).cmd("--telemetry").description("write counters and timers of the run to a JSON report, <entry>_telemetry.json (one per request in server mode)")),
+		opt_trace		 (SwitchOption::Make(*this).cmd("--trace").description("write a timeline of the run in Chrome trace-event format, <entry>_trace.json")),
+		opt_lp_output	 (SwitchOption::Make(*this).cmd("--lp").cmd("--lp-output").description("also output as IPET constraints in a lp_solve .lp file (requires -o)")),
 		opt_nffi		 (SwitchOption::Make(*this).cmd("--nffi").cmd("--no-formatted-flowinfo").description("(debugging) format flowinfo in paths like a list of items instead of pretty-printing it")),
 		opt_automerge	 (SwitchOption::Make(*this).cmd("-a").cmd("--automerge").description("let the algorithm decide when to merge")),
 		opt_applymerge	 (SwitchOption::Make(*this).cmd("--maf").cmd("--merge-after-apply").description("(optimization) allow the algorithm to merge immediately after applying")),
@@ -73,10 +85,23 @@ public:
 		opt_reduce		 (SwitchOption::Make(*this).cmd("--reduce").description("reduce irregular loops")),
 		opt_slice		 (SwitchOption::Make(*this).cmd("--slice").description("slice away instructions that do not impact the control flow (warning: removes infeasible paths)")),
 		opt_dumpoptions	 (SwitchOption::Make(*this).cmd("--dump-options").cmd("--do").description("print the selected options for the analysis")),
+		opt_wto			 (SwitchOption::Make(*this).cmd("--wto").description("(v3) iterate over the weak topological order of CFGs instead of using a working list")),
+		opt_subsumed	 (SwitchOption::Make(*this).cmd("--rs").cmd("--remove-subsumed").description("(post-processing) remove infeasible paths that contain a smaller infeasible path")),
+		opt_liveness	 (SwitchOption::Make(*this).cmd("--liveness").description("(v3, optimization) prune dead registers and stack cells at the end of blocks")),
 		opt_output 		 (ValueOption<bool>::Make(*this).cmd("-o").cmd("--output").description("output the result of the analysis to a FFX file").def(false)),
 		opt_merge 		 (ValueOption<int>::Make(*this).cmd("-m").cmd("--merge").description("merge when exceeding X states at a control point").def(0)),
+		opt_transfer_cache(ValueOption<int>::Make(*this).cmd("--tc").cmd("--transfer-cache").description("(v3, optimization) memoize the transfer of basic blocks, keeping up to X entries").def(0)),
 		opt_multithreading(ValueOption<int>::Make(*this).cmd("-j").description("(unstable) enable multithreading on the given amount of cores (0/1=no multithreading, -1=autodetect)").def(0)),
-		opt_x 			 (ValueOption<int>::Make(*this).cmd("-x").description("(internal) flags for debugging of SMT solving").def(0)) { }
+		opt_x 			 (ValueOption<int>::Make(*this).cmd("-x").description("(internal) flags for debugging of SMT solving").def(0)),
+		opt_summary_cache(ValueOption<string>::Make(*this).cmd("--sc").cmd("--summary-cache").description("(v3, optimization) reuse the function summaries stored in the given directory, and store the new ones there").def("")),
+		opt_result_cache (ValueOption<string>::Make(*this).cmd("--rc").cmd("--result-cache").description("reuse the results of a previous run on the same binary with the same options, stored in the given directory").def("")),
+		opt_server		 (ValueOption<string>::Make(*this).cmd("--server").description("(v3) keep the program loaded and serve analysis requests on the given Unix socket").def("")),
+		opt_batch		 (ValueOption<string>::Make(*this).cmd("--batch").description("run the jobs (binary, entry, options) listed in the given manifest, loading each binary once").def("")),
+		opt_batch_jobs	 (ValueOption<int>::Make(*this).cmd("--bj").cmd("--batch-jobs").description("maximum number of cores used by the running batch jobs, each job counting for its -j (0=one per core)").def(0)),
+		opt_ffx_stream	 (ValueOption<string>::Make(*this).cmd("--fs").cmd("--ffx-stream").description("write the infeasible paths to the given FFX file as soon as they are found (before post-processing)").def("")),
+		opt_summary_checkpoint	 (ValueOption<string>::Make(*this).cmd("--scp").cmd("--summary-checkpoint").description("(v3) periodically save the summaries of the completed callee functions to the given file (the fixpoint of a function still being analyzed, the entry function included, is not saved)").def("")),
+		opt_summary_checkpoint_interval(ValueOption<int>::Make(*this).cmd("--scpi").cmd("--summary-checkpoint-interval").description("(v3) minimum number of seconds between two summary checkpoints").def(300)),
+		opt_resume_summaries	 (SwitchOption::Make(*this).cmd("--resume-summaries").description("(v3) load the function summaries of the file given to --summary-checkpoint, and only analyze the remaining functions")) { }
 
 protected:
 	virtual void work(const string &entry, PropList &props) throw (elm::Exception)
@@ -89,29 +114,35 @@ protected:
 		if(opt_dumpoptions)
 			dumpOptions(analysis_flags, merge_thresold, nb_cores);
 
-		if(analysis_flags & Analysis::REDUCE_LOOPS)
+		ANALYSIS_FLAGS(props) = analysis_flags;
+		MERGE_THRESOLD(props) = merge_thresold;
+		NB_CORES(props) = nb_cores;
+		TRANSFER_CACHE_SIZE(props) = opt_transfer_cache.get();
+		SUMMARY_CACHE_PATH(props) = opt_summary_cache.get();
+		RESULT_CACHE_PATH(props) = opt_result_cache.get();
+		FFX_STREAM_PATH(props) = opt_ffx_stream.get();
+		SUMMARY_CHECKPOINT(props) = opt_summary_checkpoint.get();
+		SUMMARY_CHECKPOINT_INTERVAL(props) = opt_summary_checkpoint_interval.get();
+		RESUME_SUMMARIES(props) = opt_resume_summaries && !opt_summary_checkpoint.get().isEmpty();
+
+		if(!opt_batch.get().isEmpty())
 		{
-			workspace()->require(REDUCED_LOOPS_FEATURE, props); // for irregular loops
-			workspace()->require(COLLECTED_CFG_FEATURE, props); // INVOLVED_CFGS
+			runBatch(props, analysis_flags, merge_thresold, nb_cores);
+			return;
 		}
-		if(analysis_flags & Analysis::VIRTUALIZE_CFG)
+		if(opt_telemetry)
+			telemetry.enable();
+		if(opt_trace)
+			trace.enable();
 		{
-			cfg_follow_calls = true;
-			workspace()->require(VIRTUALIZED_CFG_FEATURE, props); // inline calls
+			Telemetry::Phase phase("cfg features");
+			requireFeatures(workspace(), analysis_flags, props);
 		}
-#ifdef OSLICE
-		if(analysis_flags & Analysis::SLICE_CFG)
+		if(!opt_server.get().isEmpty())
 		{
-			// oslice::SLICING_CFG_OUTPUT_PATH(props) = "slicing.dot";
-			// oslice::SLICED_CFG_OUTPUT_PATH(props) = "sliced.dot";
-			workspace()->require(oslice::COND_BRANCH_COLLECTOR_FEATURE, props);
-			workspace()->require(oslice::SLICER_FEATURE, props);
+			serve(entry, props, analysis_flags, merge_thresold, nb_cores);
+			return;
 		}
-#endif
-
-		ANALYSIS_FLAGS(props) = analysis_flags;
-		MERGE_THRESOLD(props) = merge_thresold;
-		NB_CORES(props) = nb_cores;
 	
 		if((analysis_flags & Analysis::VERSION) < 3)
 			workspace()->require(OLD_INFEASIBLE_PATHS_FEATURE, props);
@@ -122,20 +153,230 @@ protected:
 		// outputing to .ffx
 		if(opt_output.get())
 		{
+			Telemetry::Phase phase("output");
+			Trace::Span span("output", "ffx output");
 			// FFX ffx_output(analysis->infeasiblePaths());
 			FFX ffx_output(INFEASIBLE_PATHS(INVOLVED_CFGS(workspace())->get(0)));
 			ffx_output.output(elm::String(entry), entry + "_ips.ffx", opt_graph_output ? entry + "_ips.tsv" : "");
+			if(opt_binary_output && !ffx_output.outputBinary(elm::String(entry), entry + "_ips.ipb"))
+				cerr << "ERROR: could not write " << entry << "_ips.ipb" << endl;
+			if(opt_lp_output && !ffx_output.outputConstraints(elm::String(entry), entry + "_ips.lp"))
+				cerr << "ERROR: could not write " << entry << "_ips.lp" << endl;
 		}
+		if(opt_telemetry && !telemetry.write(entry + "_telemetry.json", entry))
+			cerr << "ERROR: could not write " << entry << "_telemetry.json" << endl;
+		if(opt_trace && !trace.write(entry + "_trace.json"))
+			cerr << "ERROR: could not write " << entry << "_trace.json" << endl;
 	}
 
 private:
 	SwitchOption opt_s0, opt_s1, opt_s2, opt_progress, opt_src_info, opt_nocolor, opt_nolinenumbers, opt_noipresults, 
-				opt_detailedstats, opt_graph_output, opt_nffi, opt_automerge, opt_applymerge, opt_clamppreds,
+				opt_detailedstats, opt_graph_output, opt_binary_output, opt_telemetry, opt_trace, opt_lp_output, opt_nffi, opt_automerge, opt_applymerge, opt_clamppreds,
 				opt_dry, opt_onlyloopbounds, opt_v1, opt_v2, opt_v3, opt_deterministic, opt_nolinearcheck, opt_no_initial_data,
 				opt_sp_critical, opt_nounminimized, opt_allownonlinearoperators, opt_nocleantops,
-				opt_dontassumeidsp, opt_nowidening, opt_reduce, opt_slice, opt_dumpoptions;
+				opt_dontassumeidsp, opt_nowidening, opt_reduce, opt_slice, opt_dumpoptions, opt_wto, opt_liveness, opt_subsumed;
 	ValueOption<bool> opt_output;
-	ValueOption<int> opt_merge, opt_multithreading, opt_x;
+	ValueOption<int> opt_merge, opt_transfer_cache, opt_multithreading, opt_x, opt_batch_jobs;
+	ValueOption<string> opt_summary_cache, opt_result_cache, opt_server, opt_batch, opt_ffx_stream, opt_summary_checkpoint;
+	ValueOption<int> opt_summary_checkpoint_interval;
+	SwitchOption opt_resume_summaries;
+
+	void requireFeatures(WorkSpace *ws, int analysis_flags, PropList &props) {
+		if(analysis_flags & Analysis::REDUCE_LOOPS)
+		{
+			ws->require(REDUCED_LOOPS_FEATURE, props); // for irregular loops
+			ws->require(COLLECTED_CFG_FEATURE, props); // INVOLVED_CFGS
+		}
+		if(analysis_flags & Analysis::VIRTUALIZE_CFG)
+		{
+			cfg_follow_calls = true;
+			ws->require(VIRTUALIZED_CFG_FEATURE, props); // inline calls
+		}
+#ifdef OSLICE
+		if(analysis_flags & Analysis::SLICE_CFG)
+		{
+			// oslice::SLICING_CFG_OUTPUT_PATH(props) = "slicing.dot";
+			// oslice::SLICED_CFG_OUTPUT_PATH(props) = "sliced.dot";
+			ws->require(oslice::COND_BRANCH_COLLECTOR_FEATURE, props);
+			ws->require(oslice::SLICER_FEATURE, props);
+		}
+#endif
+	}
+	// options that can be changed by a request in server or batch mode
+	static int requestFlag(const elm::String& name) {
+		if(name == "rs")		return Analysis::REMOVE_SUBSUMED;
+		if(name == "liveness")	return Analysis::LIVENESS_PRUNING;
+		if(name == "wto")		return Analysis::WTO_ITERATION;
+		if(name == "maf")		return Analysis::MERGE_AFTER_APPLY;
+		if(name == "cp")		return Analysis::CLAMP_PREDICATE_SIZE;
+		if(name == "dry")		return Analysis::DRY_RUN;
+		if(name == "id")		return Analysis::USE_INITIAL_DATA;
+		return 0;
+	}
+	// set the options of a request over the ones of the command line
+	static bool applyRequest(const Server::Request& req, int analysis_flags, int merge_thresold, int nb_cores, PropList &props, elm::String& error) {
+		int flags = analysis_flags;
+		for(int i = 0; i < req.switches.length(); i++)
+		{
+			const int f = requestFlag(req.switches[i].fst);
+			if(!f)
+			{
+				error = _ << "unknown option \"" << req.switches[i].fst << "\"";
+				return false;
+			}
+			flags = req.switches[i].snd ? (flags | f) : (flags & ~f);
+		}
+		if(req.merge >= 0)
+			flags = req.merge ? (flags | Analysis::MERGE) : (flags & ~Analysis::MERGE);
+		ANALYSIS_FLAGS(props) = flags;
+		MERGE_THRESOLD(props) = req.merge >= 0 ? req.merge : merge_thresold;
+		NB_CORES(props) = req.threads >= 0 ? req.threads : nb_cores;
+		return true;
+	}
+	static t::int64 now_us() {
+		struct timeval tim;
+		gettimeofday(&tim, NULL);
+		return tim.tv_sec*1000000+tim.tv_usec;
+	}
+	// server mode: the workspace, the DAG and the function summaries stay loaded, requests are served until "quit"
+	void serve(const string &entry, PropList &props, int analysis_flags, int merge_thresold, int nb_cores) {
+		ASSERTP((analysis_flags & Analysis::VERSION) == 3, "Server mode requires the v3 analysis (-3).")
+		Server server(opt_server.get());
+		if(!server.open())
+		{
+			cerr << "Could not listen on " << server.path() << endl;
+			return;
+		}
+		cout << "Serving requests on " << server.path() << endl;
+		RESIDENT_SUMMARIES(props) = true; // safe with functions of several callers: the summary key does not depend on the caller
+		Analysis2 analysis;
+		elm::String loaded = entry, task_entry; // task_entry keeps the name TASK_ENTRY points to
+		Server::Request req;
+		while(server.next(req))
+		{
+			telemetry.reset(); // one report per request
+			elm::String error;
+			if(!applyRequest(req, analysis_flags, merge_thresold, nb_cores, props, error))
+			{
+				server.reply(_ << "error " << error);
+				continue;
+			}
+
+			const t::int64 t0 = now_us();
+			try
+			{
+				if(req.entry != loaded)
+				{	// the CFGs of another entry function, the rest of the workspace is kept
+					workspace()->invalidate(COLLECTED_CFG_FEATURE);
+					loaded = ""; // nothing is loaded until the CFGs of the new entry are
+					task_entry = req.entry;
+					TASK_ENTRY(props) = task_entry.toCString();
+					Telemetry::Phase phase("cfg features");
+					workspace()->require(COLLECTED_CFG_FEATURE, props);
+					requireFeatures(workspace(), ANALYSIS_FLAGS(props), props);
+					loaded = req.entry;
+				}
+				const t::int64 t1 = now_us();
+				workspace()->invalidate(INFEASIBLE_PATHS_FEATURE);
+				analysis.process(workspace(), props);
+				const Vector<DetailedPath>& ips = INFEASIBLE_PATHS(INVOLVED_CFGS(workspace())->get(0));
+				if(!req.output.isEmpty())
+				{
+					FFX ffx_output(ips);
+					ffx_output.output(req.entry, req.output, "");
+				}
+				if(opt_telemetry && !telemetry.write(_ << req.entry << "_telemetry.json", req.entry))
+					cerr << "ERROR: could not write " << req.entry << "_telemetry.json" << endl;
+				const t::int64 t2 = now_us();
+				server.reply(_ << "ok ips=" << ips.count() << " cfgs=" << INVOLVED_CFGS(workspace())->count()
+					<< " load_ms=" << (t1-t0)/1000 << " analysis_ms=" << (t2-t1)/1000);
+			}
+			catch(elm::Exception& e)
+			{
+				server.reply(_ << "error " << e.message());
+			}
+		}
+		cout << "Server stopped" << endl;
+	}
+	// batch mode: each binary of the manifest is loaded once, its jobs are run by forked processes that share it
+	void runBatch(PropList &props, int analysis_flags, int merge_thresold, int nb_cores) {
+		const elm::String stats = _ << opt_batch.get() << ".stats";
+		Batch batch(opt_batch_jobs.get(), stats);
+		if(!batch.read(opt_batch.get()))
+			return;
+		const Vector<Batch::Job>& jobs = batch.jobs();
+		::unlink(stats.toCString());
+		Batch::record(stats, "binary\tentry\tstatus\tips\tload_ms\tanalysis_ms");
+		for(int i = 0; i < jobs.length(); i++)
+		{
+			const elm::String& binary = jobs[i].binary;
+			bool loaded = false;
+			for(int j = 0; j < i && !loaded; j++)
+				loaded = jobs[j].binary == binary;
+			if(loaded)
+				continue;
+			WorkSpace *ws = NULL;
+			try
+			{
+				ws = binary == workspace()->process()->program()->name() ? workspace() : MANAGER.load(elm::sys::Path(binary), props);
+				ws->require(dfa::INITIAL_STATE_FEATURE, props); // shared by all the jobs on this binary
+			}
+			catch(elm::Exception& e)
+			{
+				for(int j = i; j < jobs.length(); j++)
+					if(jobs[j].binary == binary)
+						Batch::record(stats, _ << binary << "\t" << jobs[j].req.entry << "\terror: " << e.message());
+				if(ws && ws != workspace())
+					delete ws;
+				continue;
+			}
+			for(int j = i; j < jobs.length(); j++)
+				if(jobs[j].binary == binary && batch.fork(j, jobs[j].req.threads >= 0 ? jobs[j].req.threads : nb_cores) == 0)
+					runJob(ws, j, jobs[j], props, analysis_flags, merge_thresold, nb_cores, stats);
+			if(ws != workspace())
+				delete ws; // the running jobs have their own copy
+		}
+		const int failed = batch.finish();
+		cout << "Batch: " << jobs.length() << " jobs, " << failed << " failed, stats in " << stats << endl;
+	}
+	// in the forked process of batch job number index, never returns
+	void runJob(WorkSpace *ws, int index, const Batch::Job& job, PropList &props, int analysis_flags, int merge_thresold, int nb_cores, const elm::String& stats) {
+		const elm::String prefix = _ << job.binary << "\t" << job.req.entry << "\t";
+		const elm::String output = job.req.output.isEmpty() // the index tells apart the jobs on the same binary and entry
+			? elm::String(_ << elm::sys::Path(job.binary).namePart() << "." << job.req.entry << "." << index << "_ips.ffx")
+			: job.req.output;
+		int status = Batch::RECORDED_FAILURE;
+		elm::String error;
+		try
+		{
+			if(!applyRequest(job.req, analysis_flags, merge_thresold, nb_cores, props, error))
+				Batch::record(stats, _ << prefix << "error: " << error);
+			else
+			{
+				const int flags = ANALYSIS_FLAGS(props);
+				const t::int64 t0 = now_us();
+				ws->invalidate(COLLECTED_CFG_FEATURE); // collected for another entry
+				TASK_ENTRY(props) = job.req.entry.toCString();
+				ws->require(COLLECTED_CFG_FEATURE, props);
+				requireFeatures(ws, flags, props);
+				const t::int64 t1 = now_us();
+				ws->require((flags & Analysis::VERSION) < 3 ? OLD_INFEASIBLE_PATHS_FEATURE : INFEASIBLE_PATHS_FEATURE, props);
+				const Vector<DetailedPath>& ips = INFEASIBLE_PATHS(INVOLVED_CFGS(ws)->get(0));
+				FFX ffx_output(ips);
+				ffx_output.output(job.req.entry, output, "");
+				const t::int64 t2 = now_us();
+				Batch::record(stats, _ << prefix << "ok\t" << ips.count() << "\t" << (t1-t0)/1000 << "\t" << (t2-t1)/1000);
+				status = 0;
+			}
+		}
+		catch(elm::Exception& e)
+		{
+			Batch::record(stats, _ << prefix << "error: " << e.message());
+		}
+		cout.flush();
+		cerr.flush();
+		_exit(status);
+	}
 
 	void setDebugFlags(void) {
 		dbg_flags = 0
@@ -169,6 +410,9 @@ private:
 			| (opt_sp_critical				? Analysis::SP_CRITICAL : 0)
 			| (opt_applymerge				? Analysis::MERGE_AFTER_APPLY : 0)
 			| (opt_clamppreds				? Analysis::CLAMP_PREDICATE_SIZE : 0)
+			| (opt_wto						? Analysis::WTO_ITERATION : 0)
+			| (opt_liveness					? Analysis::LIVENESS_PRUNING : 0)
+			| (opt_subsumed					? Analysis::REMOVE_SUBSUMED : 0)
 			| ((opt_merge || opt_automerge)	? Analysis::MERGE : 0)
 			| (true 						? Analysis::POST_PROCESSING : 0)
 		;
@@ -246,12 +490,50 @@ private:
 		DBGOPT("RUN DRY (NO SMT SOLVER)"		, analysis_flags & Analysis::DRY_RUN, false)
 		DBGOPT("MERGE AFTER APPLYING A FUNCTION", analysis_flags & Analysis::MERGE_AFTER_APPLY, false)
 		DBGOPT("CLAMP PREDICATE SIZE"			, analysis_flags & Analysis::CLAMP_PREDICATE_SIZE, false)
+		DBGOPT("WEAK TOPOLOGICAL ORDER"			, analysis_flags & Analysis::WTO_ITERATION, false)
+		DBGOPT("LIVENESS PRUNING"				, analysis_flags & Analysis::LIVENESS_PRUNING, false)
+		DBGOPT("REMOVE SUBSUMED PATHS"			, analysis_flags & Analysis::REMOVE_SUBSUMED, false)
 		cout << DBGPREFIX("A.I. VERSION") << color::ICya() << (analysis_flags & Analysis::VERSION) << color::RCol() << endl;
 		cout << DBGPREFIX("MERGING THRESOLD");
 		if(analysis_flags & Analysis::MERGE)
 			cout << color::IRed() << merge_thresold << color::RCol() << endl;
 		else
 			cout << color::IGre() << "NONE" << color::RCol() << endl;
+		cout << DBGPREFIX("TRANSFER CACHE SIZE");
+		if(opt_transfer_cache.get() > 0)
+			cout << color::IRed() << opt_transfer_cache.get() << color::RCol() << endl;
+		else
+			cout << color::IGre() << "NONE" << color::RCol() << endl;
+		cout << DBGPREFIX("SUMMARY CACHE");
+		if(!opt_summary_cache.get().isEmpty())
+			cout << color::IRed() << opt_summary_cache.get() << color::RCol() << endl;
+		else
+			cout << color::IGre() << "NONE" << color::RCol() << endl;
+		cout << DBGPREFIX("RESULT CACHE");
+		if(!opt_result_cache.get().isEmpty())
+			cout << color::IRed() << opt_result_cache.get() << color::RCol() << endl;
+		else
+			cout << color::IGre() << "NONE" << color::RCol() << endl;
+		cout << DBGPREFIX("FFX STREAM");
+		if(!opt_ffx_stream.get().isEmpty())
+			cout << color::IRed() << opt_ffx_stream.get() << color::RCol() << endl;
+		else
+			cout << color::IGre() << "NONE" << color::RCol() << endl;
+		cout << DBGPREFIX("SUMMARY CHECKPOINT");
+		if(!opt_summary_checkpoint.get().isEmpty())
+			cout << color::IRed() << opt_summary_checkpoint.get() << color::RCol() << " (every " << opt_summary_checkpoint_interval.get() << "s" << (opt_resume_summaries ? ", resuming" : "") << ")" << endl;
+		else
+			cout << color::IGre() << "NONE" << color::RCol() << endl;
+		cout << DBGPREFIX("BATCH");
+		if(!opt_batch.get().isEmpty())
+			cout << color::IRed() << opt_batch.get() << color::RCol() << " (" << opt_batch_jobs.get() << " cores max)" << endl;
+		else
+			cout << color::IGre() << "NONE" << color::RCol() << endl;
+		cout << DBGPREFIX("SERVER");
+		if(!opt_server.get().isEmpty())
+			cout << color::IRed() << opt_server.get() << color::RCol() << endl;
+		else
+			cout << color::IGre() << "NONE" << color::RCol() << endl;
 		cout << "=============================================" << endl;
 		#undef DBGOPT
 		#undef DBGPREFIX
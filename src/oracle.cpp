@@ -29,6 +29,8 @@
 #include "oracle.h"
 #include "progress.h"
 #include "smt_job.h"
+#include "telemetry.h"
+#include "trace.h"
 #ifdef SMT_SOLVER_CVC4
 	#include "cvc4/cvc4_smt.h"
  	typedef CVC4SMT chosen_smt_t;
@@ -44,6 +46,8 @@ LockPtr<Analysis::States> DefaultAnalysis::join(const Vector<Edge*>& ins) const
 {
 	ASSERTP(ins, "join given empty ingoing edges vector")
 	LockPtr<States> v = vectorOfS(ins);
+	if(version() > 1) // v1 labels predicates with the edges of their path, we cannot merge them
+		v->collapseDuplicates();
 
 	if((flags&MERGE) && v->count() > state_size_limit) // check for too large states
 		v = merge(v, ins[0]->target());
@@ -61,6 +65,8 @@ LockPtr<Analysis::States> DefaultAnalysis::merge(LockPtr<States> v, Block* b) co
 	}
 	else
 	{
+		telemetry.count(Telemetry::MERGES);
+		telemetry.count(Telemetry::MERGED_STATES, v->count());
 		State s((Edge*)NULL, context, dag, false); // entry is cleared anyway
 		s.merge(*v, b, *vm); // s <- merging(s0, s1, ..., sn)
 		LockPtr<States> rtnv(new States(1));
@@ -93,7 +99,7 @@ bool DefaultAnalysis::inD_ip(const otawa::Edge* e) const
 }
 
 // look for infeasible paths, add them to infeasible_paths, and removes the states from ss
-Analysis::IPStats DefaultAnalysis::ipcheck(States& ss, Vector<DetailedPath>& infeasible_paths) const
+Analysis::IPStats DefaultAnalysis::ipcheck(States& ss, InfeasiblePaths& infeasible_paths) const
 // void Analysis::stateListToInfeasiblePathList(SLList<Option<Path> >& sl_paths, const SLList<Analysis::State>& sl, Edge* e, bool is_conditional)
 {
 	IPStats stats;
@@ -101,6 +107,7 @@ Analysis::IPStats DefaultAnalysis::ipcheck(States& ss, Vector<DetailedPath>& inf
 		return stats;
 
 	const int state_count = ss.count();
+	Trace::Span span("smt", "ipcheck", "states", state_count);
 	SolverProgress* sprogress;
 	if(flags&SHOW_PROGRESS)
 		sprogress = new SolverProgress(state_count);
@@ -118,7 +125,7 @@ Analysis::IPStats DefaultAnalysis::ipcheck(States& ss, Vector<DetailedPath>& inf
 		States::Iter si(ss.states());
 		for(int tid = 0, i = 0; tid < nb_threads; tid++)
 		{
-			SMTJob<chosen_smt_t>* job = new SMTJob<chosen_smt_t>(flags);
+			SMTJob<chosen_smt_t>* job = new SMTJob<chosen_smt_t>(flags, tid+1); // same track for the worker of the same index in every batch
 			const int thresold = state_count * (tid+1)/nb_threads; // add states until this thresold
 			DBGG("\tthread #" << tid << ", doing jobs [" << i << "," << thresold << "[")
 			for(; i < thresold; i++, si++)
@@ -214,6 +221,24 @@ Analysis::IPStats DefaultAnalysis::ipcheck(States& ss, Vector<DetailedPath>& inf
 					DBG(color::IRed() << "Ignored infeasible path that could not be minimized")
 			}
 			onAnyInfeasiblePath();
+			// the states collapsed into s have the same predicates, so their paths are infeasible too
+			for(SLList<DetailedPath>::Iterator ai(s.getAliasPaths()); ai; ai++)
+			{
+				Path aip;
+				for(DetailedPath::EdgeIterator ei(*ai); ei; ei++)
+					aip += *ei;
+				stats.onAnyInfeasiblePath();
+				if(checkInfeasiblePathValidity(ss.states(), sv_paths, aip, counterexample))
+				{
+					DetailedPath alias_path(*ai);
+					alias_path.optimize();
+					addDetailedInfeasiblePath(alias_path, infeasible_paths);
+					DBG(color::On_IRed() << "Inf. path found: " << alias_path << color::RCol() << " (collapsed state)")
+				}
+				else
+					stats.onUnminimizedInfeasiblePath();
+				onAnyInfeasiblePath();
+			}
 			delete *pi;
 		}
 	}
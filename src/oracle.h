@@ -36,7 +36,7 @@ protected:
 	LockPtr<States> join(const Vector<Edge*>& edges) const;
 	LockPtr<States> merge(LockPtr<States>, Block* b) const;
 	bool inD_ip(const otawa::Edge* e) const;
-	IPStats ipcheck(States& ss, Vector<DetailedPath>& infeasible_paths) const;
+	IPStats ipcheck(States& ss, InfeasiblePaths& infeasible_paths) const;
 
 	LockPtr<States> vectorOfS(const Vector<Edge*>& ins) const;
 };
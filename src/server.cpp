@@ -0,0 +1,229 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <cerrno>
+#include <cstdlib> // strtol
+#include <cstring> // memset, memcpy
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <elm/string.h>
+#include "server.h"
+
+using namespace elm;
+
+/**
+ * @class Server
+ * @brief Receives analysis requests for a resident pathfinder process.
+ * A client connects to the socket, sends one line and reads one line back, then the connection is closed.
+ * A request is "<entry> [output=<file>] [merge=<n>] [j=<n>] [+<option>|-<option>]...", or "quit" to stop the server.
+ * The reply starts with "ok" followed by the results as name=value pairs, or with "error" followed by a message.
+ * Requests are served one at a time, in the order they arrive. A request longer than MAX_LINE characters, or that is not
+ * complete within TIMEOUT seconds of the connection, is answered with an error so that a stuck client cannot block the others.
+ */
+Server::Server(const elm::String& path) : _path(path), sock(-1), client(-1) { }
+
+Server::~Server()
+{
+	if(client >= 0)
+		::close(client);
+	if(sock >= 0)
+	{
+		::close(sock);
+		::unlink(_path.toCString());
+	}
+}
+
+/**
+ * @fn bool Server::open();
+ * @brief Create the socket and start listening on it, replacing the socket of a previous server
+ * @return false if the socket could not be created, or if the path exists and is not a socket
+ */
+bool Server::open()
+{
+	struct sockaddr_un addr;
+	if(_path.isEmpty() || _path.length() >= int(sizeof(addr.sun_path)))
+		return false;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, _path.chars(), _path.length());
+	sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if(sock < 0)
+		return false;
+	struct stat st;
+	if(::lstat(_path.toCString(), &st) == 0)
+	{	// only a socket left by a previous server may be replaced
+		if(!S_ISSOCK(st.st_mode) || ::unlink(_path.toCString()) < 0)
+		{
+			::close(sock);
+			sock = -1;
+			return false;
+		}
+	}
+	if(::bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(sock, 8) < 0)
+	{
+		::close(sock);
+		sock = -1;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @fn bool Server::next(Request& req);
+ * @brief Wait for the next well-formed request, answering the malformed ones
+ * @return false when the server must stop (quit request or socket error)
+ */
+bool Server::next(Request& req)
+{
+	for(;;)
+	{
+		client = ::accept(sock, NULL, NULL);
+		if(client < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return false;
+		}
+		// one deadline for the whole request: a client sending a byte now and then cannot hold the server
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		const t::int64 deadline = t::int64(now.tv_sec) * 1000 + now.tv_nsec / 1000000 + TIMEOUT * 1000;
+		StringBuffer buf;
+		const char* error = NULL;
+		for(int length = 0; !error; )
+		{
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			const t::int64 left = deadline - (t::int64(now.tv_sec) * 1000 + now.tv_nsec / 1000000);
+			struct pollfd pfd;
+			pfd.fd = client;
+			pfd.events = POLLIN;
+			const int ready = left > 0 ? ::poll(&pfd, 1, int(left)) : 0;
+			if(ready < 0 && errno == EINTR)
+				continue;
+			if(ready == 0)
+			{
+				error = "error request timed out";
+				break;
+			}
+			char c;
+			const ssize_t n = ready > 0 ? ::read(client, &c, 1) : -1;
+			if(n < 0)
+				error = "error could not read the request";
+			else if(n == 0 || c == '\n')
+				break;
+			else if(++length > MAX_LINE)
+				error = "error request too long";
+			else if(c != '\r')
+				buf << c;
+		}
+		if(error)
+		{
+			reply(error);
+			continue;
+		}
+		const String line = buf.toString();
+		if(line == "quit")
+		{
+			reply("ok");
+			return false;
+		}
+		if(parse(line, req))
+			return true;
+		reply(_ << "error malformed request \"" << line << "\"");
+	}
+}
+
+/**
+ * @fn void Server::reply(const elm::String& line);
+ * @brief Answer the current request and close its connection
+ */
+void Server::reply(const elm::String& line)
+{
+	if(client < 0)
+		return;
+	const String s = _ << line << "\n";
+	for(int done = 0; done < s.length(); )
+	{
+		const ssize_t n = ::send(client, s.chars() + done, s.length() - done, MSG_NOSIGNAL); // the client may be gone
+		if(n <= 0)
+			break;
+		done += n;
+	}
+	::close(client);
+	client = -1;
+}
+
+bool Server::parse(const elm::String& line, Request& req)
+{
+	genstruct::Vector<String> tokens;
+	StringBuffer token;
+	for(int i = 0; i <= line.length(); i++)
+	{
+		if(i < line.length() && line[i] != ' ' && line[i] != '\t')
+			token << line[i];
+		else if(token.length() > 0)
+		{
+			tokens.push(token.toString());
+			token.reset();
+		}
+	}
+	if(tokens.isEmpty())
+		return false;
+
+	req.entry = tokens[0];
+	req.output = "";
+	req.merge = -1;
+	req.threads = -1;
+	req.switches.clear();
+	for(int i = 1; i < tokens.length(); i++)
+	{
+		const String& t = tokens[i];
+		if(t.startsWith("output="))
+			req.output = t.substring(7);
+		else if(t.startsWith("merge="))
+		{
+			const String n = t.substring(6);
+			char* end;
+			const long merge = strtol(n.toCString(), &end, 10);
+			if(n.isEmpty() || *end || merge < 0)
+				return false;
+			req.merge = int(merge);
+		}
+		else if(t.startsWith("j="))
+		{
+			const String n = t.substring(2);
+			char* end;
+			const long threads = strtol(n.toCString(), &end, 10);
+			if(n.isEmpty() || *end || threads < 0)
+				return false;
+			req.threads = int(threads);
+		}
+		else if(t.length() > 1 && (t[0] == '+' || t[0] == '-'))
+			req.switches.push(pair(t.substring(1), t[0] == '+'));
+		else
+			return false;
+	}
+	return true;
+}
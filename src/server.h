@@ -0,0 +1,58 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _SERVER_H
+#define _SERVER_H
+
+#include <elm/genstruct/Vector.h>
+#include <elm/string/String.h>
+#include <elm/util/Pair.h>
+
+// Analysis requests received on a Unix domain socket, one per connection
+class Server
+{
+public:
+	class Request {
+	public:
+		elm::String entry; // function to analyze
+		elm::String output; // FFX file to write the results to, empty for none
+		int merge; // merge threshold, -1 to keep the one of the command line
+		int threads; // cores of the analysis (as -j), -1 to keep the ones of the command line
+		elm::genstruct::Vector<elm::Pair<elm::String, bool> > switches; // options turned on (+name) or off (-name)
+	};
+
+	static const int MAX_LINE = 4096; // longest request, in characters
+	static const int TIMEOUT = 10; // seconds a client has to send its request
+
+	Server(const elm::String& path);
+	~Server();
+	bool open();
+	bool next(Request& req);
+	void reply(const elm::String& line);
+	inline const elm::String& path() const { return _path; }
+	static bool parse(const elm::String& line, Request& req);
+
+private:
+	elm::String _path;
+	int sock, client;
+};
+
+#endif
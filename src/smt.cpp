@@ -22,13 +22,36 @@
 #include <elm/genstruct/SLList.h>
 #include "smt.h"
 #include "debug.h"
+#include "telemetry.h"
+#include "trace.h"
 
 /**
  * @class SMT
  * @author Jordy Ruiz
  * @brief Interface with the SMT solver
  */
-SMT::SMT(int flags) : flags(flags) { }
+SMT::SMT(int flags) : flags(flags), status(SOLVED) { }
+
+/**
+ * @fn bool SMT::check();
+ * @brief Check the satisfiability of what was initialized, recording the query in the telemetry.
+ * Unknown and failed queries are taken as satisfiable, but counted apart.
+ */
+bool SMT::check()
+{
+	Trace::Span span("smt", "query");
+	const t::int64 start = telemetry.isEnabled() ? Telemetry::now() : 0;
+	status = SOLVED;
+	const bool sat = checkPredSat();
+	if(telemetry.isEnabled())
+	{
+		telemetry.sample(Telemetry::SMT_LATENCY_US, Telemetry::now() - start);
+		telemetry.count(Telemetry::SMT_QUERIES);
+		telemetry.count(status == UNKNOWN ? Telemetry::SMT_UNKNOWN : status == FAILED ? Telemetry::SMT_ERRORS
+			: sat ? Telemetry::SMT_SAT : Telemetry::SMT_UNSAT);
+	}
+	return sat;
+}
 
 /**
  * @fn Option<Analysis::Path> SMT::seekInfeasiblePaths(const Analysis::State& s);
@@ -45,7 +68,7 @@ Option<Analysis::Path*> SMT::seekInfeasiblePaths(const Analysis::State& s)
 	
 	initialize(labelled_preds);
 	ELM_DBGV(1, "Checking path " << s.dumpPath() << ": ")
-	if(checkPredSat())
+	if(check())
 	{
 		if(dbg_verbose == DBG_VERBOSE_ALL) cout << color::BGre() << "SAT\n";
 		return elm::none;
@@ -89,7 +112,7 @@ Option<Analysis::Path*> SMT::seekInfeasiblePathsv2(const Analysis::State& s)
 	initialize(s.getLabelledPreds());
 	initialize(s.getLocalVariables(), s.getMemoryTable(), s.getDag());
 	ELM_DBGV(1, "Checking path " << s.dumpPath() << ": ")
-	if(checkPredSat())
+	if(check())
 	{
 		if(dbg_verbose == DBG_VERBOSE_ALL) cout << color::BGre() << "SAT\n";
 		return elm::none;
@@ -201,102 +224,4 @@ SLList<Analysis::Path> SMT::getAllInfeasiblePaths(const SLList<LabelledPredicate
 		return paths;
 	}
 }
-
-// generate maps
-void SMT::genPathPointBitMaps(const SLList<Analysis::Path>& paths, AVLMap<const Edge*, unsigned int>& map_pathpoint_to_bit, Vector<const Edge*>& map_bit_to_pathpoint)
-{
-	unsigned int bit_count = 0;
-	for(SLList<Analysis::Path>::Iterator iter(paths); iter; iter++)
-	{
-		Analysis::Path p = *iter;
-		for(Analysis::Path::Iterator subiter(p); subiter; subiter++)
-		{
-			if(!map_pathpoint_to_bit.hasKey(*subiter))
-			{
-				// DBG(bit_count << " <=> " << *subiter)
-				map_pathpoint_to_bit.put(*subiter, bit_count++);
-				map_bit_to_pathpoint.push(*subiter);
-			}
-		}
-	}
-}
-
-// map paths to bitcodes
-SLList<BitVector> SMT::genBitCodes(const SLList<Analysis::Path>& paths, const AVLMap<const Edge*, unsigned int>& map_pathpoint_to_bit, unsigned int used_bits)
-{
-	BitVector bitcode(used_bits);
-	SLList<BitVector> bitcode_list;
-	for(SLList<Analysis::Path>::Iterator iter(paths); iter; iter++)
-	{
-		bitcode.clear();
-		Analysis::Path p = *iter;
-		for(Analysis::Path::Iterator subiter(p); subiter; subiter++)
-			bitcode.set(*map_pathpoint_to_bit.get(*subiter));
-			// bitcode |= 1u << *map_pathpoint_to_bit.get(*subiter);
-		bitcode_list += bitcode;
-	}
-	return bitcode_list;
-}
-
-BitVector SMT::getListOfPathsToKeep(const SLList<BitVector>& bitcode_list)
-{
-	const int number_of_paths = bitcode_list.count();
-	BitVector paths_to_keep(number_of_paths, true); // a priori, keep all paths
-	int i = 0;
-	for(SLList<BitVector>::Iterator iter(bitcode_list); iter; iter++, i++)
-	{
-		if(!paths_to_keep[i])
-			continue;
-
-		SLList<BitVector>::Iterator subiter(iter);
-		subiter++;
-		for(int j = i+1; subiter; subiter++, j++)
-		{
-			if(!paths_to_keep[j])
-				continue;
-			const BitVector &opd1 = *iter, &opd2 = *subiter;
-			if(opd1 <= opd2)
-			{	// opd2 is superfluous
-				paths_to_keep.set(j, false);
-				continue;
-			}
-			if(opd1 >= opd2)
-			{	// opd1 is superfluous
-				paths_to_keep.set(i, false);
-				break;
-			}
-		}
-	}
-	return paths_to_keep;
-}
-
-SLList<Analysis::Path> SMT::filterPaths(const SLList<BitVector>& bitcode_list, const Vector<const Edge*>& map_bit_to_pathpoint, const BitVector& paths_to_keep, bool print_results)
-{
-	SLList<Analysis::Path> filtered_paths;
-	int index = 0;
-	for(SLList<BitVector>::Iterator iter(bitcode_list); iter; iter++, index++)
-	{
-		if(!paths_to_keep[index])
-			continue;
-		Analysis::Path path; // this is a SLList
-		elm::String str = "[";
-		bool first = true;
-		for(BitVector::OneIterator oneiter(*iter); oneiter; oneiter++)
-		{
-			const Edge* e = map_bit_to_pathpoint[*oneiter];
-			if(first)
-				first = false;
-			else
-				str = str.concat(_ << ", ");
-			str = str.concat(_ << e->source()->number() << "->" << e->target()->number());
-			// path.addLast(e); // preserving order for aesthetic purposes
-			path += e;
-		}
-		str = str.concat(_ << "]");
-		if(print_results)
-			DBG(color::On_IRed() << "Inf. path found: " << str << " (bitcode=" << *iter << ")")
-		filtered_paths += path;
-	}
-	return filtered_paths;
-}
 */
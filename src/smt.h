@@ -48,13 +48,20 @@ public:
 	static const elm::String printChosenSolverInfo();
 	
 private:
+	bool check();
 	virtual void initialize(const SLList<LabelledPredicate>& labelled_preds) = 0;
 	virtual void initialize(const LocalVariables& lv, const genstruct::HashTable<Constant, const Operand*, ConstantHash>& mem, DAG& dag) = 0;
 	virtual bool checkPredSat() = 0;
 	virtual bool retrieveUnsatCore(Analysis::Path& path, const SLList<LabelledPredicate>& labelled_preds, std::basic_string<char>& unsat_core_output) = 0;
 
 protected:
+	typedef enum {
+		SOLVED,  // sat or unsat, as checkPredSat() returned
+		UNKNOWN, // the solver gave up, checkPredSat() returned true
+		FAILED   // the solver failed, checkPredSat() returned true
+	} status_t;
 	int flags;
+	status_t status; // of the last checkPredSat(), set by the solvers when not SOLVED
 };
 
 #endif
@@ -27,15 +27,17 @@
 #define SMT_JOB_H
 
 #include <elm/sys/Thread.h>
+#include "trace.h"
 
 template<class SMT> class SMTJob : public elm::sys::Runnable {
 	typedef Pair<const Analysis::State*, Option<Analysis::Path*> > pair_t;
 	typedef Vector<pair_t > data_t;
 
 public:
-	SMTJob(int flags) : flags(flags) { }
+	SMTJob(int flags, int slot) : flags(flags), slot(slot) { } // slot: trace track of the worker, 1 and above
 
 	void run() {
+		Trace::setSlot(slot);
 		for(data_t::Iter iter(data); iter; iter++) {
 			SMT smt(flags);
 			const Analysis::State* s = (*iter).fst;
@@ -52,7 +54,7 @@ public:
 	typedef data_t::Iter Iterator;
 
 private:
-	int flags;
+	int flags, slot;
 	data_t data;
 };
 
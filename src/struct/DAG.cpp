@@ -25,6 +25,7 @@
  *      Author: casse
  */
 
+#include <time.h>
 #include "../debug.h"
 #include "DAG.h"
 
@@ -260,6 +261,50 @@ void testOperands(DAG& d)
 	DBG("oae = roae:\t" << DBG_TEST(oae == reverse_oae, true))
 	DBG("oae = oae4:\t" << DBG_TEST(oae == oae4, false))
 }
+// counts the nodes of an operand tree, recursing through Operand::accept or through staticAccept
+template <bool STATIC>
+class NodeCounter : public OperandVisitor
+{
+public:
+	NodeCounter() : count(0) { }
+	bool visit(const OperandConst& o) { count++; return true; }
+	bool visit(const OperandVar& o) { count++; return true; }
+	bool visit(const OperandMem& o) { count++; return true; }
+	bool visit(const OperandTop& o) { count++; return true; }
+	bool visit(const OperandIter& o) { count++; return true; }
+	bool visit(const OperandArith& o) { count++; return child(o.leftOperand()) && (o.isUnary() || child(o.rightOperand())); }
+	t::uint64 count;
+private:
+	inline bool child(const Operand& o) { return STATIC ? staticAccept(o, *this) : o.accept(*this); }
+};
+
+template <bool STATIC>
+static t::uint64 timeCounter(const Operand* o, int rounds, t::uint64& nodes)
+{
+	struct timespec t0, t1;
+	NodeCounter<STATIC> counter;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for(int i = 0; i < rounds; i++)
+		staticAccept(*o, counter);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	nodes = counter.count;
+	return t::uint64(t1.tv_sec - t0.tv_sec) * 1000000000 + t1.tv_nsec - t0.tv_nsec;
+}
+
+// compares the traversal of a deep operand through the virtual visitors (compatibility layer) and the static dispatch
+void benchVisitors(DAG& d)
+{
+	const Operand* e = d.var(0);
+	for(int i = 1; i < 1000; i++)
+		e = d.add(d.mul(e, d.cst(i)), d.var(i % 8));
+	const int rounds = 10000;
+	t::uint64 vnodes, snodes;
+	const t::uint64 vns = timeCounter<false>(e, rounds, vnodes), sns = timeCounter<true>(e, rounds, snodes);
+	ASSERT(vnodes == snodes);
+	elm::cout << "--- Visitors on " << vnodes / rounds << " nodes, " << rounds << " rounds ---" << io::endl;
+	elm::cout << "virtual accept:\t" << vns / 1000000 << "ms (" << double(vns) / vnodes << "ns/node)" << io::endl;
+	elm::cout << "staticAccept:\t" << sns / 1000000 << "ms (" << double(sns) / snodes << "ns/node)" << io::endl;
+}
 /*
 int _main(void)
 {
@@ -268,6 +313,7 @@ int _main(void)
 	testOperands(dag);
 	testPredicates(dag);
 	testSimplify(dag);
+	benchVisitors(dag);
 	DBG("diag: " << dag)
 	DBG("==================================\n")
 	Predicate *p = dag.eq(dag.sub(dag.neg(dag.add(dag.cst(2),dag.cst(2))), dag.sub(dag.mul(dag.cst(2),dag.cst(3)), dag.add(dag.mul(dag.cst(2),dag.cst(47)),dag.mul(dag.cst(2),dag.cst(13))))),
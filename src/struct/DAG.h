@@ -206,6 +206,8 @@ public:
 	inline const Operand *mem(const OperandMem& opd_mem)
 		{ return mem(opd_mem.addr().value()); }
 	const Operand* get(const Operand& opd);
+	inline int operandCount(void) const { return cst_map.count() + op_map.count(); }
+	inline int predicateCount(void) const { return pred_map.count(); }
 
 private:
 	const Operand *op(arithoperator_t op, const Operand *arg);
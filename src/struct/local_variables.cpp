@@ -112,6 +112,37 @@ void LocalVariables::onEdge(Edge* e)
  * @brief      Resets temporary variables; aka clears [thresold; size[
  */
 
+/**
+ * @brief      Hash the operands (by pointer, consistently with operator==)
+ */
+elm::t::hash LocalVariables::hash() const
+{
+	elm::t::hash h = size;
+	for(int i = 0; i < size; i++)
+		h = h * 31 + elm::t::hash((elm::t::intptr)o[i]);
+	return h;
+}
+
+/**
+ * @brief      Compare the labels and the updated marks (the operands are compared by operator==)
+ */
+bool LocalVariables::sameLabelsAs(const LocalVariables& lv) const
+{
+	if(size != lv.size || !(u == lv.u))
+		return false;
+	for(int i = 0; i < size; i++)
+	{
+		const int n = l[i] ? l[i]->count() : 0, m = lv.l[i] ? lv.l[i]->count() : 0;
+		if(n != m)
+			return false;
+		if(n)
+			for(labels_t::Iter e(*l[i]); e; e++)
+				if(!lv.l[i]->contains(*e))
+					return false;
+	}
+	return true;
+}
+
 /**
  * @brief      Merge current LocalVariables with a provided one
  *
@@ -112,6 +112,8 @@ public:
 		{ array::clear(o+thresold, size-thresold); }
 	void onEdge(Edge* e);
 	void merge(const LocalVariables& lv); // this = this ∩ lv
+	elm::t::hash hash() const; // only hashes operands!
+	bool sameLabelsAs(const LocalVariables& lv) const; // labels and updated marks
 
 	LocalVariables& operator=(const LocalVariables& lv);
 	inline bool operator==(const LocalVariables& lv) const // only compares operands!
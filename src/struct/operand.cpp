@@ -122,7 +122,7 @@
  */
 /**
  * @fn operand_kind_t Operand::kind() const;
- * @brief Returns an operand kind, in order to characterize each implementation of Operand
+ * @brief Returns an operand kind, in order to characterize each implementation of Operand (read from a tag, not virtual)
  */
 
 OperandTop const* const Top = new OperandTop(-1);
@@ -156,9 +156,9 @@ inline void Operand::Iter::check()
 }
 
 // Operands: Constants
-OperandConst::OperandConst(const OperandConst& opd) : _value(opd._value) { }
-OperandConst::OperandConst(const Constant& value) : _value(value) { }
-OperandConst::OperandConst() : _value(0) { }
+OperandConst::OperandConst(const OperandConst& opd) : Operand(CST), _value(opd._value) { }
+OperandConst::OperandConst(const Constant& value) : Operand(CST), _value(value) { }
+OperandConst::OperandConst() : Operand(CST), _value(0) { }
 OperandConst::~OperandConst() { }
 // Operand* OperandConst::copy() const { return new OperandConst(_value); }
 io::Output& OperandConst::print(io::Output& out) const { return out << _value; }
@@ -196,9 +196,9 @@ const Operand* OperandConst::replaceConstants(DAG& dag, const ConstantVariablesC
 	{ return this; }
 
 // Operands: Variables
-OperandVar::OperandVar() : _addr(777) { }
-OperandVar::OperandVar(const OperandVar& opd) : _addr(opd._addr) { }
-OperandVar::OperandVar(t::int32 addr) : _addr(addr) { }
+OperandVar::OperandVar() : Operand(VAR, varFootprint(777)), _addr(777) { }
+OperandVar::OperandVar(const OperandVar& opd) : Operand(VAR, opd._footprint), _addr(opd._addr) { }
+OperandVar::OperandVar(t::int32 addr) : Operand(VAR, varFootprint(addr)), _addr(addr) { }
 // OperandVar::~OperandVar() { }
 // Operand* OperandVar::copy() const { return new OperandVar(_addr); }
 io::Output& OperandVar::print(io::Output& out) const
@@ -209,7 +209,7 @@ io::Output& OperandVar::print(io::Output& out) const
 		out << "t" << -_addr; // temporary
 	return out; 
 }
-OperandVar& OperandVar::operator=(const OperandVar& opd){ _addr = opd._addr; return *this; }
+OperandVar& OperandVar::operator=(const OperandVar& opd){ _addr = opd._addr; _footprint = opd._footprint; return *this; }
 bool OperandVar::operator<(const Operand& o) const
 {
 	if(kind() > o.kind())
@@ -254,13 +254,13 @@ const Operand* OperandVar::replaceConstants(DAG& dag, const ConstantVariablesCor
 }
 
 // Operands: Memory
-OperandMem::OperandMem(const OperandConst& opdc) : _opdc(opdc) { }
-OperandMem::OperandMem(const OperandMem& opd) : _opdc(opd.addr()) { }
-OperandMem::OperandMem() { }
+OperandMem::OperandMem(const OperandConst& opdc) : Operand(MEM, memFootprint(opdc.value()), opdc.value().isRelative() ? this : NULL), _opdc(opdc) { }
+OperandMem::OperandMem(const OperandMem& opd) : Operand(MEM, opd._footprint, opd._stack ? this : NULL), _opdc(opd.addr()) { }
+OperandMem::OperandMem() : Operand(MEM, memFootprint(Constant(0))) { }
 io::Output& OperandMem::print(io::Output& out) const
 	{ return out << "[" << _opdc << "]"; }
 OperandMem& OperandMem::operator=(const OperandMem& opd)
-	{ _opdc = opd._opdc; return *this; }
+	{ _opdc = opd._opdc; _footprint = opd._footprint; _stack = opd._stack ? this : NULL; return *this; }
 bool OperandMem::operator<(const Operand& o) const
 {
 	if(kind() > o.kind())
@@ -299,9 +299,9 @@ Option<Constant> OperandMem::involvesStackBelow(const Constant& stack_limit) con
  
 // Operands: Top
 // OperandTop::OperandTop() : id(next_id++) { }
-OperandTop::OperandTop(int id) : id(id) { }
-OperandTop::OperandTop(const OperandTop& opd) : id(opd.id) { }
-OperandTop::OperandTop(const OperandTop& opd, int offset) : id(opd.id + offset) { }
+OperandTop::OperandTop(int id) : Operand(TOP), id(id) { }
+OperandTop::OperandTop(const OperandTop& opd) : Operand(TOP), id(opd.id) { }
+OperandTop::OperandTop(const OperandTop& opd, int offset) : Operand(TOP), id(opd.id + offset) { }
 io::Output& OperandTop::print(io::Output& out) const
 {
 	if(id == -1)
@@ -352,12 +352,38 @@ bool OperandIter::operator<(const Operand& o) const {
  
 // Operands: Arithmetic expressions
 OperandArith::OperandArith(arithoperator_t opr, const Operand* opd1_, const Operand* opd2_)
-	: _opr(opr), opd1(opd1_), opd2(opd2_) { }
+	: Operand(ARITH, opd1_->footprint() | (opd2_ ? opd2_->footprint() : 0)), _opr(opr), opd1(opd1_), opd2(opd2_)
+{
+	// the children are already summarized, so this is done in constant time
+	_depth = 1 + opd1->depth();
+	_temps = opd1->countTempVars();
+	_mem = opd1->involvesMemory();
+	_stack = opd1->lowestStackCell();
+	bool complete = opr() != ARITHOPR_CMP && opd1->isComplete(), constant = opd1->isConstant(), tops = hasTops(opd1);
+	if(isBinary())
+	{
+		if(opd2->depth() >= _depth)
+			_depth = 1 + opd2->depth();
+		_temps += opd2->countTempVars();
+		if(!_mem)
+			_mem = opd2->involvesMemory();
+		if(const OperandMem* stack2 = opd2->lowestStackCell())
+			if(!_stack || stack2->addr().value().val() < _stack->addr().value().val())
+				_stack = stack2;
+		complete = complete && opd2->isComplete();
+		constant = constant && opd2->isConstant();
+		tops = tops || hasTops(opd2);
+	}
+	_flags = (complete ? SUM_COMPLETE : 0) | (constant ? SUM_CONSTANT : 0) | (tops ? SUM_TOPS : 0)
+		| (computeLinear(false) ? SUM_LINEAR : 0) | (computeLinear(true) ? SUM_LINEAR_OPR : 0);
+}
+bool OperandArith::hasTops(const Operand* opd)
+	{ return opd->kind() == TOP || (opd->kind() == ARITH && (opd->toArith()._flags & SUM_TOPS)); }
 io::Output& OperandArith::print(io::Output& out) const
 {
 	if(isUnary())
 	{
-		out << _opr;
+		out << opr();
 		if(opd1->kind() == ARITH)
 			out << "(" << *opd1 << ")";
 		else
@@ -369,7 +395,7 @@ io::Output& OperandArith::print(io::Output& out) const
 			out << "(" << *opd1 << ")";
 		else
 			out << *opd1;
-		out << " " << _opr << " ";
+		out << " " << opr() << " ";
 		if(opd2->kind() == ARITH)
 			out << "(" << *opd2 << ")";
 		else
@@ -399,12 +425,6 @@ bool OperandArith::operator==(const Operand& o) const
 	OperandArith& o_arith = (OperandArith&)o; // Force conversion
 	return (o.kind() == kind()) && (_opr == o_arith._opr) && (*opd1 == *(o_arith.opd1)) && (isUnary() || *opd2 == *(o_arith.opd2));
 }
-unsigned int OperandArith::countTempVars() const
-{
-	if(isUnary())
-		return opd1->countTempVars();
-	return opd1->countTempVars() + opd2->countTempVars();
-}
 bool OperandArith::getIsolatedTempVar(OperandVar& temp_var, Operand const*& expr) const
 {
 	expr = this;
@@ -418,6 +438,8 @@ int OperandArith::involvesVariable(const OperandVar& opdv) const
 }
 Option<Constant> OperandArith::involvesStackBelow(const Constant& stack_limit) const
 {
+	if(!_stack || _stack->addr().value().val() >= stack_limit.val()) // nothing low enough in this subtree
+		return elm::none;
 	if(isUnary())
 		return opd1->involvesStackBelow(stack_limit);
 	if(const Option<Constant>& opd1_rtn = opd1->involvesStackBelow(stack_limit))
@@ -431,15 +453,6 @@ bool OperandArith::involvesMemoryCell(const OperandMem& opdm) const
 		return opd1->involvesMemoryCell(opdm);
 	return opd1->involvesMemoryCell(opdm) || opd2->involvesMemoryCell(opdm);
 }
-const Operand* OperandArith::involvesMemory() const
-{
-	if(isUnary())
-		return opd1->involvesMemory();
-	else if(const Operand* rtn = opd1->involvesMemory())
-		return rtn;
-	else
-		return opd2->involvesMemory();
-}
 Option<const Operand*> OperandArith::update(DAG& dag, const Operand* opd, const Operand* opd_modifier) const
 {
 	bool rtn = false;
@@ -466,15 +479,15 @@ Option<const Operand*> OperandArith::update(DAG& dag, const Operand* opd, const
 			n2 = *new_opd2;
 			rtn = true;
 		}
-		return rtn ? some(dag.autoOp(_opr, n1, n2)) : none;
+		return rtn ? some(dag.autoOp(opr(), n1, n2)) : none;
 	}
 	else
-		return rtn ? some(dag.autoOp(_opr, n1)) : none;		
+		return rtn ? some(dag.autoOp(opr(), n1)) : none;		
 }
 
 void OperandArith::parseAffineEquation(AffineEquationState& state) const
 {
-	switch(_opr)
+	switch(opr())
 	{
 		case ARITHOPR_NEG:
 			state.reverseSign();
@@ -505,7 +518,7 @@ Option<Constant> OperandArith::evalConstantOperand() const
 	{
 #		define VAL1 (*val1)//.val()
 #		define VAL2 (*val2)//.val()
-		switch(_opr)
+		switch(opr())
 		{
 			case ARITHOPR_NEG:
 				return -VAL1;
@@ -547,12 +560,12 @@ elm::Pair<const Operand*, Constant> OperandArith::extractAdditiveConstant(DAG& d
 	let(o1, k1) = opd1->extractAdditiveConstant(dag);
 	if(isUnary())
 	{
-		ASSERT(_opr == ARITHOPR_NEG);
+		ASSERT(opr() == ARITHOPR_NEG);
 		ASSERTP(o1, "TODO")
-		return pair(dag.autoOp(_opr, o1), -k1);
+		return pair(dag.autoOp(opr(), o1), -k1);
 	}
 	let(o2, k2) = opd2->extractAdditiveConstant(dag);
-	if(_opr == ARITHOPR_ADD)
+	if(opr() == ARITHOPR_ADD)
 	{
 		const Operand* rtn;
 		if(o1)
@@ -590,7 +603,7 @@ Option<const Operand*> OperandArith::simplify(DAG& dag) const
 	if(isUnary())
 	{
 		if(Option<const Operand*> o = opd1->simplify(dag))
-			return some(dag.autoOp(_opr, *o));
+			return some(dag.autoOp(opr(), *o));
 		return none; // if there was anything to simplify, it would have been done earlier with evalConstantOperand
 	}
 	// binary case
@@ -608,7 +621,7 @@ Option<const Operand*> OperandArith::simplify(DAG& dag) const
 	Constant opd1_val, opd2_val;
 	if(opd1_is_constant) opd1_val = new_opd1->toConstant();
 	if(opd2_is_constant) opd2_val = new_opd2->toConstant();
-	switch(_opr)
+	switch(opr())
 	{
 		case ARITHOPR_ADD:
 			if(opd1_is_constant && opd1_val == 0)
@@ -634,7 +647,7 @@ Option<const Operand*> OperandArith::simplify(DAG& dag) const
 	}
 	// additional tests
 	// TODO: test [x + y / x - -y] and vice-versa
-	switch(_opr)
+	switch(opr())
 	{
 		case ARITHOPR_ADD:
 			if(opd1->kind() == ARITH && opd1->toArith().opr() == ARITHOPR_NEG)
@@ -667,20 +680,20 @@ Option<const Operand*> OperandArith::simplify(DAG& dag) const
 const Operand* OperandArith::replaceConstants(DAG& dag, const ConstantVariablesCore& constants, Vector<OperandVar>& replaced_vars) const
 {
 	return dag.autoOp(
-		_opr,
+		opr(),
 		opd1->replaceConstants(dag, constants, replaced_vars),
 		isBinary() ? opd2->replaceConstants(dag, constants, replaced_vars) : NULL);
 }
 
 /**
  * @fn bool OperandArith::isLinear(bool only_linear_opr) const
- * @brief      Determines if the operandlinear.
+ * @brief      Determines if the operandlinear (computed once at creation by computeLinear).
  * @param      only_linear_opr  Only allow linear operators
  * @return     True if linear, False otherwise.
  */
-bool OperandArith::isLinear(bool only_linear_opr) const
+bool OperandArith::computeLinear(bool only_linear_opr) const
 {
-	switch(_opr)
+	switch(opr())
 	{
 		// linear iff all operands are linear
 		case ARITHOPR_NEG:
@@ -22,6 +22,8 @@
 #ifndef _OPERAND_H
 #define _OPERAND_H
 
+#include <cstdlib>
+#include <new>
 #include <otawa/cfg/Edge.h>
 #include <elm/genstruct/SLList.h>
 #include <elm/genstruct/Vector.h>
@@ -112,7 +114,22 @@ public:
 class Operand
 {
 public:
+	// over-approximation of the variables and memory cells involved in an operand, one bit per class of variables.
+	// Only a pre-filter: the predicate scans of State stay linear in the number of predicates, the footprint
+	// spares the recursive involvesVariable/involvesMemoryCell traversal of the predicates that cannot match
+	typedef t::uint64 footprint_t;
+	static const footprint_t FOOTPRINT_TEMPVARS = footprint_t(0xff) << 48; // bits 48-55: temporary variables
+	static const footprint_t FOOTPRINT_MEMORY   = footprint_t(0xff) << 56; // bits 56-63: memory cells
+	static inline footprint_t varFootprint(t::int32 addr)
+		{ return addr >= 0 ? footprint_t(1) << (addr % 48) : footprint_t(1) << (48 + (-addr-1) % 8); }
+	static inline footprint_t memFootprint(const Constant& addr)
+		{ return footprint_t(1) << (56 + addr.hash() % 8); }
+
 	virtual ~Operand() { }
+	inline footprint_t footprint() const { return _footprint; }
+	inline bool mayInvolve(footprint_t f) const { return (_footprint & f) != 0; }
+	inline int depth() const { return _depth; } // height of the operand tree
+	inline const OperandMem* lowestStackCell() const { return _stack; } // stack cell with the lowest address in the operand, or NULL
 	// virtual Operand* copy() const = 0;
 	virtual unsigned int countTempVars() const = 0; // this will count a variable several times if it occurs several times
 	virtual bool getIsolatedTempVar(OperandVar& temp_var, Operand const*& expr) const = 0;
@@ -137,7 +154,7 @@ public:
 	virtual const Operand* replaceConstants(DAG& dag, const ConstantVariablesCore& constants, Vector<OperandVar>& replaced_vars) const = 0;
 	virtual bool accept(OperandVisitor& visitor) const = 0;
 	virtual const Operand* accept(OperandEndoVisitor& visitor) const = 0;
-	virtual operand_kind_t kind() const = 0;
+	inline operand_kind_t kind() const { return (operand_kind_t)_kind; }
 	friend inline io::Output& operator<<(io::Output& out, const Operand& o) { return o.print(out); }
 	virtual bool operator==(const Operand& o) const = 0;
 	virtual bool operator< (const Operand& o) const = 0;
@@ -175,6 +192,14 @@ public:
 		SLList<const Operand*> q;
 		const int flags;
 	};
+protected:
+	inline Operand(operand_kind_t kind, footprint_t footprint = 0, const OperandMem* stack = NULL)
+		: _kind(kind), _depth(1), _footprint(footprint), _stack(stack) { }
+	unsigned char _kind; // operand_kind_t tag, for static dispatch
+	// summaries computed once by the constructors, operands are immutable in the DAG
+	unsigned short _depth;
+	footprint_t _footprint;
+	const OperandMem* _stack;
 private:
 	virtual io::Output& print(io::Output& out) const = 0;
 };
@@ -212,7 +237,6 @@ public:
 	inline bool isAffine(const Operand& opd) const { return true; }
 	inline bool accept(OperandVisitor& visitor) const { return visitor.visit(*this); }
 	inline const Operand* accept(OperandEndoVisitor& visitor) const { return visitor.visit(*this); }
-	inline operand_kind_t kind() const { return CST; }
 	inline operator Constant() const { return _value; }
 	OperandConst& operator=(const OperandConst& opd);
 	inline bool operator==(const Operand& o) const { return (kind() == o.kind()) && toConstant() == o.toConstant(); }
@@ -263,7 +287,6 @@ public:
 	inline bool isAffine(const Operand& opd) const { return *this == opd; }
 	inline bool accept(OperandVisitor& visitor) const { return visitor.visit(*this); }
 	inline const Operand* accept(OperandEndoVisitor& visitor) const { return visitor.visit(*this); }
-	inline operand_kind_t kind() const { return VAR; }
 	OperandVar& operator=(const OperandVar& opd);
 	bool operator==(const Operand& o) const;
 	bool operator< (const Operand& o) const;
@@ -309,7 +332,6 @@ public:
 	inline bool isAffine(const Operand& opd) const { return *this == opd; }
 	inline bool accept(OperandVisitor& visitor) const { return visitor.visit(*this); }
 	inline const Operand* accept(OperandEndoVisitor& visitor) const { return visitor.visit(*this); }
-	inline operand_kind_t kind() const { return MEM; }
 	OperandMem& operator=(const OperandMem& opd);
 	inline bool operator==(const Operand& o) const { return (kind() == o.kind()) && (addr() == ((OperandMem&)o).addr()); }
 	bool operator< (const Operand& o) const;
@@ -357,7 +379,6 @@ public:
 	inline bool isAffine(const Operand& opd) const { return *this == opd; }
 	inline bool accept(OperandVisitor& visitor) const { return visitor.visit(*this); }
 	inline const Operand* accept(OperandEndoVisitor& visitor) const { return visitor.visit(*this); }
-	inline operand_kind_t kind() const { return TOP; }
 	OperandTop& operator=(const OperandTop& opd);
 	inline bool operator==(const Operand& o) const { return kind() == o.kind() && id == ((OperandTop&)o).id; }
 	bool operator< (const Operand& o) const;
@@ -376,8 +397,8 @@ extern OperandTop const* const Top;
 class OperandIter : public Operand
 {
 public:
-	OperandIter(const otawa::Block* loop, bool done = false) : lid(loop), done(done) { }
-	OperandIter(const OperandIter& opd) : lid(opd.lid), done(opd.done) { }
+	OperandIter(const otawa::Block* loop, bool done = false) : Operand(ITER), lid(loop), done(done) { }
+	OperandIter(const OperandIter& opd) : Operand(ITER), lid(opd.lid), done(opd.done) { }
 	
 	inline const otawa::Block* loop() const { return lid; }
 	inline bool isDone() const { return done; }
@@ -405,7 +426,6 @@ public:
 	inline bool isAffine(const Operand& opd) const { return *this == opd; }
 	inline bool accept(OperandVisitor& visitor) const { return visitor.visit(*this); }
 	inline const Operand* accept(OperandEndoVisitor& visitor) const { return visitor.visit(*this); }
-	inline operand_kind_t kind() const { return ITER; }
 	OperandIter& operator=(const OperandIter& opd) { lid = opd.lid; done = opd.done; return *this; }
 	inline bool operator==(const Operand& o) const { return o.kind() == ITER && lid == static_cast<const OperandIter&>(o).lid && done == static_cast<const OperandIter&>(o).done; }
 	bool operator< (const Operand& o) const;
@@ -427,8 +447,13 @@ public:
 	// OperandArith(arithoperator_t opr, const Operand& opd1_, const Operand& opd2_);
 	OperandArith(arithoperator_t opr, const Operand* opd1_, const Operand* opd2_ = NULL);
 	// ~OperandArith();
+	// a node is allocated on its own cache line, that holds all its fields
+	static const size_t CACHE_LINE = 64;
+	static inline void* operator new(size_t s)
+		{ void* p; if(posix_memalign(&p, CACHE_LINE, s)) throw std::bad_alloc(); return p; }
+	static inline void operator delete(void* p) { free(p); }
 	
-	inline arithoperator_t opr() const { return _opr; }
+	inline arithoperator_t opr() const { return (arithoperator_t)_opr; }
 	inline const Operand* left() const { return opd1; }
 	inline const Operand* right() const { return opd2; }
 	inline const Operand& leftOperand() const { return *opd1; }
@@ -438,31 +463,31 @@ public:
 	inline bool isBinary() const { return _opr >= ARITHOPR_ADD; }
 	
 	// Operand* copy() const;
-	unsigned int countTempVars() const;
+	inline unsigned int countTempVars() const { return _temps; }
 	bool involves(const Operand* o) const { return this == o || opd1 == o || opd2 == o; }
 	int involvesOperand(const Operand& opd) const { return opd1->involvesOperand(opd) + (opd2 ? opd2->involvesOperand(opd) : 0); }
 	inline int involvesVariable(const OperandVar& opdv) const;
 	Option<Constant> involvesStackBelow(const Constant& stack_limit) const;
 	bool involvesMemoryCell(const OperandMem& opdm) const;
 	bool getIsolatedTempVar(OperandVar& temp_var, Operand const*& expr) const;
-	const Operand* involvesMemory() const;
+	inline const Operand* involvesMemory() const { return _mem; }
 	int count() const { return isBinary() ? opd1->count() + opd2->count() : opd1->count(); }
-	inline void collectTops(VarCollector& vc) const { opd1->collectTops(vc); if(isBinary()) opd2->collectTops(vc); }
+	inline void collectTops(VarCollector& vc) const { if(_flags & SUM_TOPS) { opd1->collectTops(vc); if(isBinary()) opd2->collectTops(vc); } }
 	Option<const Operand*> update(DAG& dag, const Operand* opd, const Operand* opd_modifier) const;
 	Option<Constant> evalConstantOperand() const;
 	elm::Pair<const Operand*, Constant> extractAdditiveConstant(DAG& dag) const;
 	Option<const Operand*> simplify(DAG& dag) const; // Warning: Option=none does not warrant that nothing has been simplified!
 	const Operand* replaceConstants(DAG& dag, const ConstantVariablesCore& constants, Vector<OperandVar>& replaced_vars) const; // warning: Option=none does not warrant that nothing has been replaced!
 	void parseAffineEquation(AffineEquationState& state) const;
-	inline void markUsedRegisters(BitVector& uses) const { opd1->markUsedRegisters(uses); if(isBinary()) opd1->markUsedRegisters(uses); }
-	inline bool isComplete() const { return _opr != ARITHOPR_CMP && opd1->isComplete() && (isUnary() || opd2->isComplete()); }
-	inline bool isConstant() const { return opd1->isConstant() && (isUnary() || opd2->isConstant()); }
-	bool isLinear(bool only_linear_opr) const;
+	inline void markUsedRegisters(BitVector& uses) const
+		{ if(_footprint & ~(FOOTPRINT_TEMPVARS | FOOTPRINT_MEMORY)) { opd1->markUsedRegisters(uses); if(isBinary()) opd2->markUsedRegisters(uses); } }
+	inline bool isComplete() const { return _flags & SUM_COMPLETE; }
+	inline bool isConstant() const { return _flags & SUM_CONSTANT; }
+	inline bool isLinear(bool only_linear_opr) const { return _flags & (only_linear_opr ? SUM_LINEAR_OPR : SUM_LINEAR); }
 	inline bool isAffine(const Operand& opd) const
 		{ return ((_opr == ARITHOPR_ADD) || (_opr == ARITHOPR_SUB)) && opd1->isAffine(opd) && opd2->isAffine(opd); }
 	inline bool accept(OperandVisitor& visitor) const { return visitor.visit(*this); }
 	inline const Operand* accept(OperandEndoVisitor& visitor) const { return visitor.visit(*this); }
-	inline operand_kind_t kind() const { return ARITH; }
 	// OperandArith& operator=(const OperandArith& opd);
 	inline bool operator==(const Operand& o) const;
 	bool operator< (const Operand& o) const;
@@ -471,11 +496,64 @@ public:
 private:
 	// NONEW;
 	io::Output& print(io::Output& out) const;
-	
-	arithoperator_t _opr;
+	bool computeLinear(bool only_linear_opr) const;
+	static bool hasTops(const Operand* opd);
+
+	enum
+	{
+		SUM_COMPLETE	= 1 << 0,
+		SUM_CONSTANT	= 1 << 1,
+		SUM_LINEAR		= 1 << 2, // isLinear(false)
+		SUM_LINEAR_OPR	= 1 << 3, // isLinear(true)
+		SUM_TOPS		= 1 << 4, // some OperandTop is involved
+	};
+
+	// packed after the header of Operand (tag, depth, footprint, stack), in 64 bytes on a 64-bit host
+	unsigned char _opr; // arithoperator_t
+	unsigned char _flags; // summary of the subtree
+	unsigned int _temps; // number of occurrences of temporary variables
 	const Operand* opd1;
 	const Operand* opd2; // unused if operator is unary
+	const Operand* _mem; // first memory cell involved
 };
+static_assert(sizeof(OperandArith) <= OperandArith::CACHE_LINE, "OperandArith does not fit in a cache line");
+
+/**
+ * Static dispatch of visitors: switch on the kind tag and call the visit() of V directly.
+ * Unlike Operand::accept(), this makes no virtual call when V is the concrete visitor class,
+ * so the recursion of a visitor on the children of an OperandArith should use these.
+ */
+template <class V>
+inline bool staticAccept(const Operand& o, V& v)
+{
+	switch(o.kind())
+	{
+		case CST:	return v.V::visit(static_cast<const OperandConst&>(o));
+		case VAR:	return v.V::visit(static_cast<const OperandVar&>(o));
+		case MEM:	return v.V::visit(static_cast<const OperandMem&>(o));
+		case TOP:	return v.V::visit(static_cast<const OperandTop&>(o));
+		case ITER:	return v.V::visit(static_cast<const OperandIter&>(o));
+		case ARITH:	return v.V::visit(static_cast<const OperandArith&>(o));
+	}
+	crash();
+	return false;
+}
+
+template <class V>
+inline const Operand* staticEndoAccept(const Operand& o, V& v)
+{
+	switch(o.kind())
+	{
+		case CST:	return v.V::visit(static_cast<const OperandConst&>(o));
+		case VAR:	return v.V::visit(static_cast<const OperandVar&>(o));
+		case MEM:	return v.V::visit(static_cast<const OperandMem&>(o));
+		case TOP:	return v.V::visit(static_cast<const OperandTop&>(o));
+		case ITER:	return v.V::visit(static_cast<const OperandIter&>(o));
+		case ARITH:	return v.V::visit(static_cast<const OperandArith&>(o));
+	}
+	crash();
+	return NULL;
+}
 
 // for v1 only // no longer
 class AffineEquationState // WARNING: this only makes sense when we know the equation is affine in one var
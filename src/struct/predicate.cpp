@@ -218,6 +218,19 @@ bool Predicate::operator==(const Predicate& p) const
 		);
 }
 
+/**
+ * @fn elm::t::hash Predicate::hash() const;
+ * @brief Hash of the operator and of the operand pointers (operands are hash-consed in the DAG).
+ * Symmetric for = and ≠, like operator==.
+ */
+elm::t::hash Predicate::hash() const
+{
+	elm::t::hash h1 = elm::t::hash((elm::t::intptr)_opd1), h2 = elm::t::hash((elm::t::intptr)_opd2);
+	if(_opr == CONDOPR_EQ || _opr == CONDOPR_NE)
+		return (h1 + h2) ^ (elm::t::hash(_opr) << 24);
+	return (h1 * 31 + h2) ^ (elm::t::hash(_opr) << 24);
+}
+
 io::Output& operator<<(io::Output& out, const condoperator_t& opr)
 {	
 	switch(opr)
@@ -55,6 +55,8 @@ public:
 	inline bool isConstant() const { return _opd1->isConstant() && _opd2->isConstant(); }
 	inline bool isLinear(bool only_linear_opr) const { return _opd1->isLinear(only_linear_opr) && _opd2->isLinear(only_linear_opr); }
 	inline bool involves(const Operand* opd) const { return _opd1->involves(opd) || _opd2->involves(opd); }
+	inline Operand::footprint_t footprint() const { return _opd1->footprint() | _opd2->footprint(); }
+	inline bool mayInvolve(Operand::footprint_t f) const { return _opd1->mayInvolve(f) || _opd2->mayInvolve(f); }
 	int involvesOperand(const Operand& opd) const;
 	int involvesVariable(const OperandVar& opdv) const;
 	Option<Constant> involvesStackBelow(const Constant& stack_limit) const;
@@ -65,6 +67,7 @@ public:
 	bool getIsolatedTempVar(OperandVar& temp_var, Operand const*& expr) const;
 	bool update(DAG& dag, const Operand* opd, const Operand* opd_modifier);
 	bool isTautology() const;
+	elm::t::hash hash() const;
 
 	bool operator==(const Predicate& p) const; // semantic equality (I don't like this)
 	inline bool operator!=(const Predicate& p) const { return !(*this == p); }
@@ -86,6 +86,20 @@ void VarMaker::shrink(const VarCollector& vc, bool clean)
 	tops.shrink(j);
 }
 
+/**
+ * @brief      Rebuilds an empty VarMaker with the given layout, e.g. when loading a stored summary
+ *
+ * @param      virtual_count  The size of the virtual space (tops imported from callees)
+ * @param      count          The amount of tops owned by this VarMaker
+ */
+void VarMaker::restore(int virtual_count, int count)
+{
+	ASSERT(isEmpty() && start == 0);
+	start = virtual_count;
+	for(int i = 0; i < count; i++)
+		tops.push(new OperandTop(start + i));
+}
+
 /**
  * @brief      Prints the VarMaker
  */
@@ -68,6 +68,8 @@ public:
 	}
 	void import(const VarMaker& vm);
 	void shrink(const VarCollector& bv, bool clean);
+	void restore(int virtual_count, int count);
+	inline const OperandTop* top(int id) const { ASSERT(start <= id && id < length()); return tops[id - start]; }
 
 private:
 	tops_t tops;
@@ -0,0 +1,898 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+ 
+#include <cstdio> // std::rename
+#include <sys/stat.h> // mkdir
+#include <elm/io/InFileStream.h>
+#include <elm/io/OutFileStream.h>
+#include <otawa/prog/Process.h>
+#include "summary_cache.h"
+#include "cfg_features.h"
+#include "struct/var_maker.h"
+
+// part of every key: bump this when the layout of summaries changes
+static const t::uint32 SUMMARY_MAGIC = 0x31534650; // "PFS1"
+static const t::uint32 CHECKPOINT_MAGIC = 0x31434650; // "PFC1"
+
+/**
+ * @class Analysis::SummaryCache::Writer
+ * @brief Serializes a summary in memory. Operands and CFGs are written once and referred to by their index afterwards:
+ * a reference is a (possibly empty) list of definitions, each introduced by -2, followed by an index or -1 (NULL).
+ */
+class Analysis::SummaryCache::Writer
+{
+public:
+	Writer() : opds(4099), opd_count(0), cfg_count(0) { }
+	inline void u8(t::uint8 x) { buf.push(x); }
+	inline void i32(t::int32 x) { for(int i = 0; i < 4; i++) buf.push(t::uint8(t::uint32(x) >> (8*i))); }
+	inline void u64(t::uint64 x) { i32(t::int32(x)); i32(t::int32(x >> 32)); }
+	inline void stats(const IPStats& st) { i32(st.getIPCount()); i32(st.getUnminimizedIPCount()); }
+	inline void raw(const Vector<t::uint8>& bytes) { i32(bytes.length()); for(int i = 0; i < bytes.length(); i++) buf.push(bytes[i]); }
+	inline void string(const elm::String& s) { i32(s.length()); for(int i = 0; i < s.length(); i++) buf.push(t::uint8(s[i])); }
+
+	void constant(const Constant& c)
+	{
+		u8(c.isAbsolute() ? CONSTANT_ABSOLUTE : c.isRelativePositive() ? CONSTANT_PLUS_SP : c.isRelativeNegative() ? CONSTANT_MINUS_SP : CONSTANT_INVALID);
+		i32(c.val());
+	}
+
+	void cfg(CFG* g)
+	{
+		if(!g)
+		{
+			i32(-1);
+			return;
+		}
+		int id = cfg_ids.get(g, -1);
+		if(id < 0)
+		{
+			i32(-2);
+			i32(g->address().offset());
+			cfg_ids.put(g, id = cfg_count++);
+		}
+		i32(id);
+	}
+
+	void block(const Block* b)
+	{
+		cfg(b ? b->cfg() : NULL);
+		if(b)
+			i32(b->index());
+	}
+
+	void edge(Edge* e)
+	{
+		block(e->source());
+		int k = 0;
+		for(Block::EdgeIter i(e->source()->outs()); *i != e; i++)
+			k++;
+		i32(k);
+	}
+
+	void operand(const Operand* o)
+	{
+		if(o)
+			define(o);
+		i32(o ? opds.get(o, -1) : -1);
+	}
+
+	void path(const DetailedPath& p)
+	{
+		cfg(p.function());
+		int n = 0;
+		for(DetailedPath::Iterator i(p); i; i++)
+			n++;
+		i32(n);
+		for(DetailedPath::Iterator i(p); i; i++)
+		{
+			u8(i->kind());
+			if(i->isEdge())
+				edge(i->getEdge());
+			else if(i->isBasicBlockKind())
+				block(i->getBasicBlock());
+			else
+				block(i->getSynthBlock());
+		}
+	}
+
+	void preds(const SLList<LabelledPredicate>& l)
+	{
+		i32(l.count());
+		for(SLList<LabelledPredicate>::Iterator i(l); i; i++)
+		{
+			u8(i->pred().opr());
+			operand(i->pred().left());
+			operand(i->pred().right());
+			int n = 0;
+			for(Set<Edge*>::Iterator e(i->labels()); e; e++)
+				n++;
+			i32(n);
+			for(Set<Edge*>::Iterator e(i->labels()); e; e++)
+				edge(*e);
+		}
+	}
+
+	inline const Vector<t::uint8>& bytes() const { return buf; }
+
+	bool flush(const elm::String& file) const
+	{
+		const elm::String tmp = _ << file << ".tmp";
+		{
+			io::OutFileStream out(tmp.toCString());
+			if(!out.isReady() || out.write((const char*)&buf[0], buf.length()) < 0)
+				return false;
+		}
+		return std::rename(tmp.toCString(), file.toCString()) == 0; // atomic, concurrent runs never see half-written summaries
+	}
+
+private:
+	// write the definitions of o and of its subtrees that were not written yet, children first
+	void define(const Operand* o)
+	{
+		if(opds.exists(o))
+			return;
+		if(o->kind() == ARITH)
+		{
+			define(o->toArith().left());
+			if(o->toArith().isBinary())
+				define(o->toArith().right());
+		}
+		i32(-2);
+		u8(o->kind());
+		switch(o->kind())
+		{
+			case CST: constant(o->toConstant()); break;
+			case VAR: i32(o->toVar().addr()); break;
+			case MEM: constant(o->toMem().addr().value()); break;
+			case TOP: i32(o->toTop().getId()); break;
+			case ITER: block(o->toIter().loop()); u8(o->toIter().isDone()); break;
+			case ARITH:
+				u8(o->toArith().opr());
+				i32(opds.get(o->toArith().left(), -1));
+				i32(o->toArith().isBinary() ? opds.get(o->toArith().right(), -1) : -1);
+				break;
+		}
+		opds.put(o, opd_count++);
+	}
+
+	Vector<t::uint8> buf;
+	elm::genstruct::HashTable<const Operand*, int> opds;
+	int opd_count;
+	elm::genstruct::HashTable<CFG*, int> cfg_ids;
+	int cfg_count;
+};
+
+/**
+ * @class Analysis::SummaryCache::Reader
+ * @brief Reads back what Writer wrote. Anything unexpected (truncated file, unknown function or block...)
+ * turns the reader into a failed state, and the summary is then ignored.
+ */
+class Analysis::SummaryCache::Reader
+{
+public:
+	Reader(SummaryCache& sc, VarMaker& vm) : sc(sc), vm(vm), pos(0), _ok(false) { }
+	inline bool ok() const { return _ok; }
+	inline bool atEnd() const { return pos == buf.length(); }
+
+	bool open(const elm::String& file)
+	{
+		io::InFileStream in(file.toCString());
+		if(!in.isReady())
+			return false;
+		char chunk[4096];
+		for(int n; (n = in.read(chunk, sizeof(chunk))) > 0; )
+			for(int i = 0; i < n; i++)
+				buf.push(t::uint8(chunk[i]));
+		return _ok = true;
+	}
+	inline void open(const Vector<t::uint8>& bytes) { buf = bytes; pos = 0; _ok = true; }
+
+	inline t::uint8 u8()
+	{
+		if(pos >= buf.length())
+		{
+			fail();
+			return 0;
+		}
+		return buf[pos++];
+	}
+	t::int32 i32()
+	{
+		t::uint32 x = 0;
+		for(int i = 0; i < 4; i++)
+			x |= t::uint32(u8()) << (8*i);
+		return t::int32(x);
+	}
+	inline t::uint64 u64() { const t::uint32 lo = i32(); return (t::uint64(t::uint32(i32())) << 32) | lo; }
+	inline IPStats stats() { const int n = i32(); return IPStats(n, i32()); }
+
+	void raw(Vector<t::uint8>& bytes)
+	{
+		const int n = i32();
+		if(n < 0 || n > buf.length() - pos)
+		{
+			fail();
+			return;
+		}
+		for(int i = 0; i < n; i++)
+			bytes.push(buf[pos++]);
+	}
+	elm::String string()
+	{
+		Vector<t::uint8> bytes;
+		raw(bytes);
+		return bytes.isEmpty() ? elm::String() : elm::String((const char*)&bytes[0], bytes.length());
+	}
+
+	Constant constant()
+	{
+		const t::uint8 kind = u8();
+		const t::int32 val = i32();
+		if(kind > CONSTANT_MINUS_SP)
+			fail();
+		return (kind == CONSTANT_INVALID || !_ok) ? Constant() : Constant(val, constant_kind_t(kind));
+	}
+
+	CFG* cfg()
+	{
+		int id = i32();
+		if(id == -2)
+		{
+			CFG* g = sc.cfgs.get(Address::offset_t(i32()), NULL);
+			if(!g)
+				fail(); // this function is not part of the program anymore
+			cfgs.push(g);
+			id = i32();
+		}
+		if(id < -1 || id >= cfgs.length())
+			fail();
+		return (id == -1 || !_ok) ? NULL : cfgs[id];
+	}
+
+	Block* block()
+	{
+		CFG* g = cfg();
+		if(!g)
+			return NULL;
+		const int index = i32();
+		if(index < 0 || index >= g->count())
+			fail();
+		return _ok ? sc.block(g, index) : NULL;
+	}
+
+	Edge* edge()
+	{
+		Block* b = block();
+		int k = i32();
+		if(b && _ok)
+			for(Block::EdgeIter i(b->outs()); i; i++)
+				if(k-- == 0)
+					return *i;
+		fail();
+		return NULL;
+	}
+
+	const Operand* operand()
+	{
+		int id = i32();
+		while(id == -2 && _ok)
+		{
+			define();
+			id = i32();
+		}
+		if(id < -1 || id >= opds.length())
+			fail();
+		return (id == -1 || !_ok) ? NULL : opds[id];
+	}
+
+	DetailedPath path()
+	{
+		DetailedPath p(cfg());
+		const int n = i32();
+		for(int k = 0; k < n && _ok; k++)
+		{
+			const t::uint8 kind = u8();
+			if(kind == DetailedPath::FlowInfo::KIND_EDGE)
+			{
+				if(Edge* e = edge())
+					p.addLast(DetailedPath::FlowInfo(e));
+				continue;
+			}
+			Block* b = block();
+			if(!b)
+				fail();
+			else if((kind == DetailedPath::FlowInfo::KIND_LOOP_ENTRY || kind == DetailedPath::FlowInfo::KIND_LOOP_EXIT) && b->isBasic())
+				p.addLast(DetailedPath::FlowInfo(DetailedPath::FlowInfo::kind_t(kind), b->toBasic()));
+			else if((kind == DetailedPath::FlowInfo::KIND_CALL || kind == DetailedPath::FlowInfo::KIND_RETURN) && b->isSynth())
+				p.addLast(DetailedPath::FlowInfo(DetailedPath::FlowInfo::kind_t(kind), b->toSynth()));
+			else
+				fail();
+		}
+		return p;
+	}
+
+	void preds(SLList<LabelledPredicate>& l)
+	{
+		const int n = i32();
+		for(int k = 0; k < n && _ok; k++)
+		{
+			const t::uint8 opr = u8();
+			const Operand* left = operand();
+			const Operand* right = operand();
+			Set<Edge*> labels;
+			const int m = i32();
+			for(int j = 0; j < m && _ok; j++)
+				if(Edge* e = edge())
+					labels.add(e);
+			if(!left || !right || opr > CONDOPR_NE)
+				fail();
+			if(_ok)
+				l.addLast(LabelledPredicate(Predicate(condoperator_t(opr), left, right), labels));
+		}
+	}
+
+	inline void fail() { _ok = false; }
+
+private:
+	void define()
+	{
+		const t::uint8 kind = u8();
+		const Operand* o = NULL;
+		switch(kind)
+		{
+			case CST: o = sc.dag->cst(constant()); break;
+			case VAR:
+			{
+				const t::int32 addr = i32();
+				if(addr >= sc.context.max_registers || -addr > sc.context.max_tempvars)
+					break;
+				o = sc.dag->var(addr);
+				break;
+			}
+			case MEM: o = sc.dag->mem(constant()); break;
+			case TOP: o = top(i32()); break;
+			case ITER:
+			{
+				Block* h = block();
+				const bool done = u8();
+				if(!h || !LOOP_HEADER(h))
+					break;
+				OperandIter* it = LH_I.get(h, NULL);
+				if(!it) // the loop was not analyzed in this run
+				{
+					LH_I(h) = it = new OperandIter(h);
+					sc.iters.push(it);
+				}
+				if(done && !it->isDone())
+					it->finalize();
+				o = it;
+				break;
+			}
+			case ARITH:
+			{
+				const t::uint8 opr = u8();
+				const t::int32 l = i32(), r = i32();
+				if(opr > ARITHOPR_CMP || l < 0 || l >= opds.length() || (opr == ARITHOPR_NEG) != (r == -1) || r >= opds.length())
+					break;
+				o = sc.dag->autoOp(arithoperator_t(opr), opds[l], r >= 0 ? opds[r] : NULL);
+				break;
+			}
+		}
+		if(!o)
+			fail();
+		opds.push(o);
+	}
+
+	const Operand* top(int id)
+	{
+		if(id == -1)
+			return Top;
+		if(id >= vm.sizes().snd && id < vm.length())
+			return vm.top(id);
+		if(id < 0 || id >= vm.sizes().snd)
+			return NULL;
+		// tops of the callees (virtual space of the VarMaker): same id, same variable
+		const Operand* opd = vtops.get(id, NULL);
+		if(!opd)
+		{
+			OperandTop* t = new OperandTop(id);
+			sc.virtual_tops.push(t);
+			vtops.put(id, opd = t);
+		}
+		return opd;
+	}
+
+	SummaryCache& sc;
+	VarMaker& vm;
+	Vector<t::uint8> buf;
+	int pos;
+	bool _ok;
+	Vector<const Operand*> opds;
+	Vector<CFG*> cfgs;
+	elm::genstruct::HashTable<int, const Operand*> vtops;
+};
+
+/**
+ * @class Analysis::SummaryCache
+ * @brief Persistent store of the context-independent summaries computed by v3 for each function.
+ * The key of a function covers its instruction bytes and block structure, the keys of its callees, the analysis options,
+ * the initial state of the memory and the pathfinder executable (not its callers: a summary is the same for all of them), so a summary is only reused when re-analyzing the function would give the same result.
+ * Functions and blocks are referred to by address and index in the files, which makes them valid across builds of the analyzed program.
+ */
+Analysis::SummaryCache::SummaryCache(const elm::String& dir, const WorkSpace* ws, const context_t& context, DAG* dag, int flags, int state_size_limit, bool resident)
+	: dir(dir), context(context), dag(dag), resident(resident ? new elm::genstruct::HashTable<elm::String, Vector<t::uint8>*>() : NULL)
+{
+	if(!dir.isEmpty())
+		mkdir(dir.toCString(), 0755); // fails harmlessly if it already exists
+	Digest d;
+	d.addFile("/proc/self/exe"); // any rebuild of the tool invalidates what it stored
+	tool = d.value();
+	reset(ws, flags, state_size_limit);
+}
+
+Analysis::SummaryCache::~SummaryCache()
+{
+	for(elm::genstruct::HashTable<CFG*, Vector<Block*>*>::PairIterator i(blocks); i; i++)
+		delete (*i).snd;
+	for(Vector<OperandTop*>::Iter i(virtual_tops); i; i++)
+		delete *i;
+	releaseIters(ws);
+	if(resident)
+	{
+		for(elm::genstruct::HashTable<elm::String, Vector<t::uint8>*>::PairIterator i(*resident); i; i++)
+			delete (*i).snd;
+		delete resident;
+	}
+}
+
+/**
+ * @fn void Analysis::SummaryCache::reset(const WorkSpace* ws, int flags, int state_size_limit);
+ * @brief Start a new run: the CFGs and the options may have changed, only the stored summaries are kept
+ */
+void Analysis::SummaryCache::reset(const WorkSpace* ws, int flags, int state_size_limit)
+{
+	releaseIters(ws); // the summaries of the previous run were removed with CFG_S
+	this->ws = ws;
+	keys.clear();
+	computing.clear();
+	cfgs.clear();
+	for(elm::genstruct::HashTable<CFG*, Vector<Block*>*>::PairIterator i(blocks); i; i++)
+		delete (*i).snd;
+	blocks.clear();
+	_hits = _misses = _stores = 0; // virtual tops are kept, states of the previous runs may still refer to them
+	for(CFGCollection::Iter cfg(INVOLVED_CFGS(ws)); cfg; cfg++)
+		cfgs.put(cfg->address().offset(), *cfg);
+
+	result_flags = flags & ~SHOW_PROGRESS;
+	Digest d; // post-processing does not change the summaries, only the results of runs
+	d << SUMMARY_MAGIC << (flags & ~(SHOW_PROGRESS | POST_PROCESSING | REMOVE_SUBSUMED)) << state_size_limit
+	  << context.sp.addr() << context.max_tempvars << context.max_registers;
+	for(dfa::State::MemIter mi(context.dfa_state); mi; mi++) // read-only data is folded into the states
+	{
+		d << (*mi).address().offset() << (*mi).value().isConst();
+		if((*mi).value().isConst())
+			d << (*mi).value().value();
+	}
+	base = d.value();
+}
+
+// delete the loop iterators created by the reader, and unset them on the blocks of ws that still have them
+void Analysis::SummaryCache::releaseIters(const WorkSpace* ws)
+{
+	if(iters.isEmpty())
+		return;
+	elm::genstruct::HashTable<const OperandIter*, bool> owned;
+	for(Vector<OperandIter*>::Iter i(iters); i; i++)
+		owned.put(*i, true);
+	for(CFGCollection::Iter cfg(INVOLVED_CFGS(ws)); cfg; cfg++) // the blocks of the CFGs of an older collection are gone
+		for(CFG::BlockIter b(cfg->blocks()); b; b++)
+			if(owned.hasKey(LH_I.get(*b, NULL)))
+				LH_I.remove(*b);
+	for(Vector<OperandIter*>::Iter i(iters); i; i++)
+		delete *i;
+	iters.clear();
+}
+
+/**
+ * @fn Analysis::SummaryCache::key_t Analysis::SummaryCache::key(CFG* cfg);
+ * @brief Key of the summary of a function, computed once per run
+ */
+Analysis::SummaryCache::key_t Analysis::SummaryCache::key(CFG* cfg)
+{
+	if(keys.exists(cfg))
+		return keys.get(cfg, 0);
+	computing.addFirst(cfg);
+	Digest d;
+	d << base << tool << cfg->address().offset() << cfg->count();
+	for(int i = 0; i < cfg->count(); i++)
+	{
+		Block* b = block(cfg, i);
+		d << t::uint8(b->isEntry() ? 0 : b->isExit() ? 1 : b->isUnknown() ? 2 : b->isCall() ? 3 : 4);
+		if(b->isBasic())
+		{
+			BasicBlock* bb = b->toBasic();
+			const int size = bb->size();
+			char* bytes = new char[size];
+			ws->process()->get(bb->address(), bytes, size);
+			d << bb->address().offset() << size;
+			d.add(bytes, size);
+			delete [] bytes;
+		}
+		else if(b->isCall())
+		{
+			CFG* callee = b->toSynth()->callee();
+			if(!callee)
+				d << key_t(0);
+			else if(computing.contains(callee)) // recursive call
+				d << key_t(1);
+			else
+				d << key(callee);
+		}
+		for(Block::EdgeIter e(b->outs()); e; e++)
+			d << e->target()->index() << e->isTaken();
+	}
+	computing.removeFirst();
+	keys.put(cfg, d.value());
+	return d.value();
+}
+
+/**
+ * @fn bool Analysis::SummaryCache::load(CFG* cfg, bool use_initial_data, LockPtr<States>& s, LockPtr<VarMaker>& vm, IPStats& stats, Vector<DetailedPath>& ips);
+ * @brief Look for a stored summary of cfg
+ * @return true if the summary was found and loaded, in which case s, vm, stats and ips are set
+ */
+bool Analysis::SummaryCache::load(CFG* cfg, bool use_initial_data, LockPtr<States>& s, LockPtr<VarMaker>& vm, IPStats& stats, Vector<DetailedPath>& ips)
+{
+	LockPtr<VarMaker> new_vm(new VarMaker());
+	Reader r(*this, *new_vm);
+	if(!fetch(fileOf(key(cfg), use_initial_data ? ".init.sum" : ".sum"), r) || r.u64() != key(cfg))
+	{
+		_misses++;
+		return false;
+	}
+	const int virtual_count = r.i32(), count = r.i32();
+	if(r.ok() && virtual_count >= 0 && count >= 0)
+		new_vm->restore(virtual_count, count);
+	else
+		r.fail();
+	const IPStats new_stats = r.stats();
+
+	LockPtr<States> new_s(new States());
+	const int n = r.i32();
+	for(int i = 0; i < n && r.ok(); i++)
+	{
+		if(!r.u8()) // invalid state
+		{
+			new_s->push(State());
+			continue;
+		}
+		State st(NULL, context, dag, false);
+		read(r, st);
+		new_s->push(st);
+	}
+	Vector<DetailedPath> new_ips;
+	const int m = r.i32();
+	for(int i = 0; i < m && r.ok(); i++)
+		new_ips.push(r.path());
+
+	if(!r.ok() || !r.atEnd())
+	{
+		DBGG("Ignoring corrupted or outdated summary of " << cfg)
+		_misses++;
+		return false;
+	}
+	s = new_s;
+	vm = new_vm;
+	stats = new_stats;
+	ips = new_ips;
+	_hits++;
+	return true;
+}
+
+/**
+ * @fn void Analysis::SummaryCache::save(CFG* cfg, bool use_initial_data, const States& s, const VarMaker& vm, const IPStats& stats, const Vector<DetailedPath>& ips);
+ * @brief Store the summary of cfg, made of its final states, VarMaker, and of the infeasible paths found in it
+ */
+void Analysis::SummaryCache::save(CFG* cfg, bool use_initial_data, const States& s, const VarMaker& vm, const IPStats& stats, const Vector<DetailedPath>& ips)
+{
+	Writer w;
+	w.u64(key(cfg));
+	w.i32(vm.sizes().snd);
+	w.i32(vm.sizes().fst);
+	w.stats(stats);
+	w.i32(s.count());
+	for(States::Iter i(s); i; i++)
+	{
+		w.u8(i->isValid());
+		if(i->isValid())
+			write(w, *i);
+	}
+	w.i32(ips.count());
+	for(Vector<DetailedPath>::Iter i(ips); i; i++)
+		w.path(*i);
+	if(store(fileOf(key(cfg), use_initial_data ? ".init.sum" : ".sum"), w))
+		_stores++;
+	else
+		DBGG("Could not store the summary of " << cfg << " in " << dir)
+}
+
+void Analysis::SummaryCache::write(Writer& w, const State& s)
+{
+	w.u8(s.bottom);
+	w.block(s.memid.b);
+	w.i32(s.memid.id);
+	w.path(s.path);
+	w.i32(s.alias_paths.count());
+	for(SLList<DetailedPath>::Iterator i(s.alias_paths); i; i++)
+		w.path(*i);
+	for(LocalVariables::Iter v(s.lvars); v; v++)
+		w.operand(s.lvars[*v]);
+	int n = 0;
+	for(State::mem_t::PairIterator i(s.mem); i; i++)
+		n++;
+	w.i32(n);
+	for(State::mem_t::PairIterator i(s.mem); i; i++)
+	{
+		w.constant((*i).fst);
+		w.operand((*i).snd);
+	}
+	w.preds(s.labelled_preds);
+	w.preds(s.generated_preds);
+	w.preds(s.generated_preds_taken);
+}
+
+void Analysis::SummaryCache::read(Reader& r, State& s)
+{
+	s.bottom = r.u8();
+	const Block* b = r.block();
+	s.memid = State::memid_t(b, short(r.i32()));
+	s.path = r.path();
+	const int n = r.i32();
+	for(int i = 0; i < n && r.ok(); i++)
+		s.alias_paths.addLast(r.path());
+	for(LocalVariables::Iter v(s.lvars); v; v++)
+		s.lvars[*v] = r.operand();
+	const int m = r.i32();
+	for(int i = 0; i < m && r.ok(); i++)
+	{
+		const Constant addr = r.constant();
+		if(const Operand* o = r.operand())
+			s.mem.put(addr, o);
+		else
+			r.fail();
+	}
+	r.preds(s.labelled_preds);
+	r.preds(s.generated_preds);
+	r.preds(s.generated_preds_taken);
+	s.invalidateFingerprint();
+}
+
+/**
+ * @fn bool Analysis::SummaryCache::loadResults(CFG* entry, IPStats& stats, Vector<DetailedPath>& ips);
+ * @brief Look for the stored results of a previous run on the same binary, entry function and options
+ * @return true if the results were found, in which case stats and ips are set
+ */
+bool Analysis::SummaryCache::loadResults(CFG* entry, IPStats& stats, Vector<DetailedPath>& ips)
+{
+	const key_t k = runKey(entry);
+	VarMaker no_vm;
+	Reader r(*this, no_vm);
+	if(!fetch(fileOf(k, ".ips"), r) || r.u64() != k)
+	{
+		_misses++;
+		return false;
+	}
+	const IPStats new_stats = r.stats();
+	Vector<DetailedPath> new_ips;
+	const int n = r.i32();
+	for(int i = 0; i < n && r.ok(); i++)
+		new_ips.push(r.path());
+	if(!r.ok() || !r.atEnd())
+	{
+		_misses++;
+		return false;
+	}
+	stats = new_stats;
+	ips = new_ips;
+	_hits++;
+	return true;
+}
+
+/**
+ * @fn void Analysis::SummaryCache::saveResults(CFG* entry, const IPStats& stats, const Vector<DetailedPath>& ips);
+ * @brief Store the final results of a run
+ */
+void Analysis::SummaryCache::saveResults(CFG* entry, const IPStats& stats, const Vector<DetailedPath>& ips)
+{
+	const key_t k = runKey(entry);
+	Writer w;
+	w.u64(k);
+	w.stats(stats);
+	w.i32(ips.count());
+	for(Vector<DetailedPath>::Iter i(ips); i; i++)
+		w.path(*i);
+	if(store(fileOf(k, ".ips"), w))
+		_stores++;
+	else
+		DBGG("Could not store the results in " << dir)
+}
+
+/**
+ * @fn bool Analysis::SummaryCache::checkpoint(const elm::String& file, CFG* entry);
+ * @brief Write the function summaries the resident cache holds to a snapshot file, atomically, so that a later run of the same analysis
+ * (same binary, entry and options) only has to load the functions that were completed. This is summary checkpointing:
+ * a function still being analyzed (its worklist, edge and loop header states, paths) is not saved, and is analyzed again from its start.
+ * The entry function is never completed before the end of the run, so a run that spends its time in the fixpoint of the entry
+ * function itself gains nothing from a checkpoint; only an engine snapshot could resume it, there is none.
+ * @return false if the file could not be written
+ */
+bool Analysis::SummaryCache::checkpoint(const elm::String& file, CFG* entry)
+{
+	ASSERTP(resident, "checkpoints are taken from a resident cache")
+	Writer w;
+	w.i32(CHECKPOINT_MAGIC);
+	w.u64(runKey(entry));
+	int n = 0;
+	for(elm::genstruct::HashTable<elm::String, Vector<t::uint8>*>::PairIterator i(*resident); i; i++)
+		n++;
+	w.i32(n);
+	for(elm::genstruct::HashTable<elm::String, Vector<t::uint8>*>::PairIterator i(*resident); i; i++)
+	{
+		w.string(dir.isEmpty() ? (*i).fst : (*i).fst.substring(dir.length() + 1)); // without the directory, which may change
+		w.raw(*(*i).snd);
+	}
+	return w.flush(file);
+}
+
+/**
+ * @fn int Analysis::SummaryCache::resume(const elm::String& file, CFG* entry);
+ * @brief Load the function summaries of a snapshot written by checkpoint() into the resident cache
+ * @return the number of stored files loaded, or -1 if the snapshot is missing, corrupted or was taken from another analysis
+ */
+int Analysis::SummaryCache::resume(const elm::String& file, CFG* entry)
+{
+	ASSERTP(resident, "checkpoints are loaded in a resident cache")
+	VarMaker no_vm;
+	Reader r(*this, no_vm);
+	if(!r.open(file) || t::uint32(r.i32()) != CHECKPOINT_MAGIC || r.u64() != runKey(entry))
+		return -1;
+	Vector<elm::String> names;
+	Vector<Vector<t::uint8>*> contents;
+	const int n = r.i32();
+	for(int i = 0; i < n && r.ok(); i++)
+	{
+		names.push(r.string());
+		contents.push(new Vector<t::uint8>());
+		r.raw(*contents.top());
+	}
+	if(!r.ok() || !r.atEnd())
+	{
+		for(Vector<Vector<t::uint8>*>::Iter i(contents); i; i++)
+			delete *i;
+		return -1;
+	}
+	for(int i = 0; i < names.length(); i++)
+	{
+		const elm::String f = fileNamed(names[i]);
+		delete resident->get(f, NULL);
+		resident->put(f, contents[i]);
+	}
+	return names.length();
+}
+
+/**
+ * @fn Analysis::SummaryCache::key_t Analysis::SummaryCache::runKey(CFG* entry);
+ * @brief Key of the results of a whole run: the binary and the entry function, all the options that change the results
+ * (post-processing included), and the pathfinder executable itself
+ */
+Analysis::SummaryCache::key_t Analysis::SummaryCache::runKey(CFG* entry)
+{
+	Digest d;
+	d << base << result_flags << entry->address().offset();
+	d.add(entry->name().chars(), entry->name().length());
+	if(!d.addFile(ws->process()->program()->name()))
+		d << key(entry); // binary not readable anymore, use the code that is analyzed
+	d << tool;
+	return d.value();
+}
+
+elm::String Analysis::SummaryCache::fileOf(key_t key, const char* ext)
+{
+	char name[17];
+	for(int i = 15; i >= 0; i--, key >>= 4)
+		name[i] = "0123456789abcdef"[key & 0xf];
+	name[16] = '\0';
+	return fileNamed(_ << name << ext);
+}
+
+elm::String Analysis::SummaryCache::fileNamed(const elm::String& name)
+{
+	if(dir.isEmpty()) // resident only
+		return name;
+	return _ << dir << "/" << name;
+}
+
+/**
+ * @fn bool Analysis::SummaryCache::fetch(const elm::String& file, Reader& r);
+ * @brief Open a stored file for reading, from memory if the cache is resident, else from the disk
+ * @return false if it was never stored
+ */
+bool Analysis::SummaryCache::fetch(const elm::String& file, Reader& r)
+{
+	if(resident)
+		if(const Vector<t::uint8>* bytes = resident->get(file, NULL))
+		{
+			r.open(*bytes);
+			return true;
+		}
+	return !dir.isEmpty() && r.open(file);
+}
+
+/**
+ * @fn bool Analysis::SummaryCache::store(const elm::String& file, const Writer& w);
+ * @brief Store what was written, in memory if the cache is resident, and on the disk if there is a directory
+ * @return true if it was stored somewhere
+ */
+bool Analysis::SummaryCache::store(const elm::String& file, const Writer& w)
+{
+	bool stored = false;
+	if(resident)
+	{
+		delete resident->get(file, NULL);
+		resident->put(file, new Vector<t::uint8>(w.bytes()));
+		stored = true;
+	}
+	if(!dir.isEmpty() && w.flush(file))
+		stored = true;
+	return stored;
+}
+
+/**
+ * @fn bool Analysis::SummaryCache::Digest::addFile(const elm::String& path);
+ * @brief Add the contents of a file to the digest
+ * @return false if the file could not be read
+ */
+bool Analysis::SummaryCache::Digest::addFile(const elm::String& path)
+{
+	io::InFileStream in(path.toCString());
+	if(!in.isReady())
+		return false;
+	char chunk[65536];
+	for(int n; (n = in.read(chunk, sizeof(chunk))) > 0; )
+		add(chunk, n);
+	return true;
+}
+
+Block* Analysis::SummaryCache::block(CFG* cfg, int index)
+{
+	Vector<Block*>* v = blocks.get(cfg, NULL);
+	if(!v)
+	{
+		v = new Vector<Block*>(cfg->count());
+		for(int i = 0; i < cfg->count(); i++)
+			v->push(NULL);
+		for(CFG::BlockIter b(cfg->blocks()); b; b++)
+			(*v)[b->index()] = *b;
+		blocks.put(cfg, v);
+	}
+	return (*v)[index];
+}
@@ -0,0 +1,105 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+ 
+#ifndef _SUMMARY_CACHE_H
+#define _SUMMARY_CACHE_H
+
+#include <elm/avl/Map.h>
+#include <elm/genstruct/HashTable.h>
+#include <elm/genstruct/Vector.h>
+#include <elm/string/String.h>
+#include <otawa/cfg/features.h>
+#include <otawa/prog/WorkSpace.h>
+#include "analysis_states.h"
+
+/**
+ * On-disk store of v3 function summaries (CFG_S and CFG_VARS, with the infeasible paths found in the function),
+ * one file per function, named after a key that covers everything the summary depends on.
+ * Also stores the final results of whole runs, keyed by the binary, the entry function and the options.
+ * A resident cache also keeps everything it stored in memory, for the next runs of the same process (server mode);
+ * it then works without a directory too. What it keeps can be written to a summary checkpoint file, for a later run to load the completed functions from
+ * (the functions still being analyzed, the entry function included, are not part of a checkpoint).
+ */
+class Analysis::SummaryCache
+{
+public:
+	typedef t::uint64 key_t;
+
+	SummaryCache(const elm::String& dir, const WorkSpace* ws, const context_t& context, DAG* dag, int flags, int state_size_limit, bool resident = false);
+	~SummaryCache();
+	void reset(const WorkSpace* ws, int flags, int state_size_limit);
+	key_t key(CFG* cfg);
+	bool load(CFG* cfg, bool use_initial_data, LockPtr<States>& s, LockPtr<VarMaker>& vm, IPStats& stats, Vector<DetailedPath>& ips);
+	void save(CFG* cfg, bool use_initial_data, const States& s, const VarMaker& vm, const IPStats& stats, const Vector<DetailedPath>& ips);
+	bool loadResults(CFG* entry, IPStats& stats, Vector<DetailedPath>& ips);
+	void saveResults(CFG* entry, const IPStats& stats, const Vector<DetailedPath>& ips);
+	bool checkpoint(const elm::String& file, CFG* entry);
+	int resume(const elm::String& file, CFG* entry);
+
+	inline int hits() const { return _hits; }
+	inline int misses() const { return _misses; }
+	inline int stores() const { return _stores; }
+
+private:
+	// 64-bit FNV-1a
+	class Digest {
+	public:
+		inline Digest() : h(0xcbf29ce484222325ULL) { }
+		inline void add(const void* p, int n)
+			{ for(int i = 0; i < n; i++) h = (h ^ ((const t::uint8*)p)[i]) * 0x100000001b3ULL; }
+		template <class T> inline Digest& operator<<(const T& x) { add(&x, sizeof(T)); return *this; }
+		bool addFile(const elm::String& path);
+		inline key_t value() const { return h; }
+	private:
+		key_t h;
+	};
+	class Writer;
+	class Reader;
+
+	void write(Writer& w, const State& s);
+	void read(Reader& r, State& s);
+	key_t runKey(CFG* entry);
+	elm::String fileOf(key_t key, const char* ext);
+	elm::String fileNamed(const elm::String& name);
+	bool fetch(const elm::String& file, Reader& r);
+	bool store(const elm::String& file, const Writer& w);
+	Block* block(CFG* cfg, int index);
+	void releaseIters(const WorkSpace* ws);
+
+	elm::String dir;
+	const WorkSpace* ws;
+	const context_t& context;
+	DAG* dag;
+	key_t base; // options, platform and initial data
+	key_t tool; // pathfinder executable
+	int result_flags; // options that change the results of a run
+	elm::genstruct::HashTable<CFG*, key_t> keys;
+	elm::genstruct::SLList<CFG*> computing; // CFGs whose key is being computed, for recursive calls
+	elm::avl::Map<Address::offset_t, CFG*> cfgs; // by address
+	elm::genstruct::HashTable<CFG*, Vector<Block*>*> blocks; // by index
+	Vector<OperandTop*> virtual_tops; // tops of callees referenced by loaded summaries
+	Vector<OperandIter*> iters; // iterators of the loops that were only loaded, not analyzed (set in LH_I)
+	elm::genstruct::HashTable<elm::String, Vector<t::uint8>*>* resident; // stored files, if kept in memory
+	int _hits, _misses, _stores;
+};
+
+#endif
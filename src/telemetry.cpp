@@ -0,0 +1,248 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <sys/time.h>
+#include <elm/io/OutFileStream.h>
+#include "telemetry.h"
+
+using namespace elm;
+
+Telemetry telemetry;
+
+static const char* counter_names[Telemetry::COUNTER_COUNT] = {
+	"blocks_processed",
+	"process_bb",
+	"merges",
+	"merged_states",
+	"applies",
+	"smt_queries",
+	"smt_sat",
+	"smt_unsat",
+	"smt_unknown",
+	"smt_errors",
+	"transfer_cache_lookups",
+	"transfer_cache_hits",
+	"summary_cache_hits",
+	"summary_cache_misses",
+	"summary_cache_stores",
+};
+
+static const char* histogram_names[Telemetry::HISTOGRAM_COUNT] = {
+	"states_per_edge",
+	"apply_product",
+	"smt_latency_us",
+};
+
+// JSON string, names of functions are the only strings that do not come from here
+static String quoted(const String& s)
+{
+	StringBuffer buf;
+	buf << '"';
+	for(int i = 0; i < s.length(); i++)
+	{
+		if(s[i] == '"' || s[i] == '\\')
+			buf << '\\';
+		if((unsigned char)s[i] >= 0x20)
+			buf << s[i];
+	}
+	buf << '"';
+	return buf.toString();
+}
+
+/**
+ * @class Telemetry
+ * @brief Performance counters and timers of a run. The report is read by tools, so names only get added, never changed.
+ */
+Telemetry::Telemetry() : enabled(false)
+{
+	reset();
+}
+
+Telemetry::Histogram::Histogram() : count(0), sum(0), max(0)
+{
+	for(int i = 0; i < BUCKETS; i++)
+		buckets[i] = 0;
+}
+
+/**
+ * @fn void Telemetry::reset();
+ * @brief Forget everything recorded so far, to report a new run of the same process (server mode)
+ */
+void Telemetry::reset()
+{
+	for(int i = 0; i < COUNTER_COUNT; i++)
+		counters[i] = 0;
+	for(int i = 0; i < HISTOGRAM_COUNT; i++)
+		histograms[i] = Histogram();
+	gauges.clear();
+	phases.clear();
+	cfgs.clear();
+	frames.clear();
+}
+
+Telemetry::Phase::~Phase()
+{
+	telemetry.phase(name, now() - start);
+}
+
+/**
+ * @fn void Telemetry::sample(histogram_t h, elm::t::int64 value);
+ * @brief Record a value in a histogram with power-of-2 buckets, keeping its maximum
+ */
+void Telemetry::sample(histogram_t h, t::int64 value)
+{
+	if(!enabled)
+		return;
+	Histogram& hist = histograms[h];
+	int b = 0;
+	if(value > 0)
+		b = 64 - __builtin_clzll(t::uint64(value));
+	if(b >= BUCKETS)
+		b = BUCKETS - 1;
+	__sync_fetch_and_add(&hist.count, 1);
+	__sync_fetch_and_add(&hist.sum, value);
+	__sync_fetch_and_add(&hist.buckets[b], 1);
+	for(t::int64 m = hist.max; value > m; m = hist.max)
+		if(__sync_bool_compare_and_swap(&hist.max, m, value))
+			break;
+}
+
+/**
+ * @fn void Telemetry::gauge(const elm::String& name, elm::t::int64 value);
+ * @brief Record a value measured once, at the end of the run (sizes of structures...). A gauge recorded again keeps its last value.
+ */
+void Telemetry::gauge(const String& name, t::int64 value)
+{
+	if(!enabled)
+		return;
+	for(int i = 0; i < gauges.length(); i++)
+		if(gauges[i].fst == name)
+		{
+			gauges[i].snd = value;
+			return;
+		}
+	gauges.push(pair(name, value));
+}
+
+/**
+ * @fn void Telemetry::phase(const elm::String& name, elm::t::int64 time_us);
+ * @brief Record the time spent in a phase of the run
+ */
+void Telemetry::phase(const String& name, t::int64 time_us)
+{
+	if(enabled)
+		phases.push(pair(name, time_us));
+}
+
+/**
+ * @fn void Telemetry::enterCFG();
+ * @brief The fixpoint of a CFG starts. CFGs analyzed before it ends are its callees, their time and blocks are reported apart.
+ */
+void Telemetry::enterCFG()
+{
+	if(!enabled)
+		return;
+	Frame f;
+	f.start = now();
+	f.blocks = counters[BLOCKS_PROCESSED];
+	f.callee_time_us = f.callee_blocks = 0;
+	frames.push(f);
+}
+
+/**
+ * @fn void Telemetry::exitCFG(const elm::String& name, int states, int tops);
+ * @brief The fixpoint of the CFG last entered is done
+ * @param name Name of the CFG
+ * @param states Number of states of its summary
+ * @param tops Number of Tops of its VarMaker
+ */
+void Telemetry::exitCFG(const String& name, int states, int tops)
+{
+	if(!enabled || frames.isEmpty())
+		return;
+	const Frame f = frames.pop();
+	CFGRecord r;
+	r.name = name;
+	r.time_us = now() - f.start;
+	r.self_time_us = r.time_us - f.callee_time_us;
+	r.blocks = counters[BLOCKS_PROCESSED] - f.blocks;
+	r.self_blocks = r.blocks - f.callee_blocks;
+	r.states = states;
+	r.tops = tops;
+	cfgs.push(r);
+	if(!frames.isEmpty())
+	{
+		Frame& caller = frames[frames.length() - 1];
+		caller.callee_time_us += r.time_us;
+		caller.callee_blocks += r.blocks;
+	}
+}
+
+/**
+ * @fn bool Telemetry::write(const elm::String& file, const elm::String& entry) const;
+ * @brief Write the JSON report
+ * @return false if the file could not be written
+ */
+bool Telemetry::write(const String& file, const String& entry) const
+{
+	io::OutFileStream stream(file);
+	if(!stream.isReady())
+		return false;
+	io::Output out(stream);
+	out << "{\n\t\"version\": 1,\n\t\"entry\": " << quoted(entry) << ",\n";
+	out << "\t\"counters\": {";
+	for(int i = 0; i < COUNTER_COUNT; i++)
+		out << (i ? ", " : "") << "\"" << counter_names[i] << "\": " << counters[i];
+	out << "},\n\t\"histograms\": {\n";
+	for(int i = 0; i < HISTOGRAM_COUNT; i++)
+	{
+		const Histogram& h = histograms[i];
+		int last = BUCKETS - 1;
+		while(last > 0 && !h.buckets[last])
+			last--;
+		out << "\t\t\"" << histogram_names[i] << "\": {\"count\": " << h.count << ", \"sum\": " << h.sum << ", \"max\": " << h.max << ", \"buckets\": [";
+		for(int b = 0; b <= last; b++)
+			out << (b ? ", " : "") << h.buckets[b];
+		out << "]}" << (i + 1 < HISTOGRAM_COUNT ? "," : "") << "\n";
+	}
+	out << "\t},\n\t\"gauges\": {";
+	for(int i = 0; i < gauges.length(); i++)
+		out << (i ? ", " : "") << quoted(gauges[i].fst) << ": " << gauges[i].snd;
+	out << "},\n\t\"phases\": [";
+	for(int i = 0; i < phases.length(); i++)
+		out << (i ? ", " : "") << "{\"name\": " << quoted(phases[i].fst) << ", \"time_us\": " << phases[i].snd << "}";
+	out << "],\n\t\"cfgs\": [";
+	for(int i = 0; i < cfgs.length(); i++)
+	{
+		const CFGRecord& r = cfgs[i];
+		out << (i ? "," : "") << "\n\t\t{\"name\": " << quoted(r.name) << ", \"time_us\": " << r.time_us << ", \"self_time_us\": " << r.self_time_us
+			<< ", \"blocks\": " << r.blocks << ", \"self_blocks\": " << r.self_blocks << ", \"states\": " << r.states << ", \"tops\": " << r.tops << "}";
+	}
+	out << (cfgs.isEmpty() ? "]\n" : "\n\t]\n") << "}\n";
+	return true;
+}
+
+t::int64 Telemetry::now()
+{
+	struct timeval tim;
+	gettimeofday(&tim, NULL);
+	return t::int64(tim.tv_sec) * 1000000 + tim.tv_usec;
+}
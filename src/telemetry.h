@@ -0,0 +1,114 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include <elm/genstruct/Vector.h>
+#include <elm/string/String.h>
+#include <elm/types.h>
+#include <elm/util/Pair.h>
+
+/**
+ * Counters, histograms and timers of a run, exported as a JSON report (--telemetry).
+ * Nothing is recorded until enable() is called. Counters and histograms may be updated from the SMT threads.
+ */
+class Telemetry
+{
+public:
+	typedef enum {
+		BLOCKS_PROCESSED,
+		PROCESS_BB,
+		MERGES,
+		MERGED_STATES,
+		APPLIES,
+		SMT_QUERIES,
+		SMT_SAT,
+		SMT_UNSAT,
+		SMT_UNKNOWN,
+		SMT_ERRORS,
+		TRANSFER_CACHE_LOOKUPS,
+		TRANSFER_CACHE_HITS,
+		SUMMARY_CACHE_HITS,
+		SUMMARY_CACHE_MISSES,
+		SUMMARY_CACHE_STORES,
+		COUNTER_COUNT
+	} counter_t;
+	typedef enum {
+		STATES_PER_EDGE,
+		APPLY_PRODUCT,
+		SMT_LATENCY_US,
+		HISTOGRAM_COUNT
+	} histogram_t;
+	static const int BUCKETS = 40; // bucket 0 counts 0, bucket i > 0 counts [2^(i-1), 2^i)
+
+	// time of a phase, from its construction to its destruction
+	class Phase {
+	public:
+		inline Phase(const char* name) : name(name), start(now()) { }
+		~Phase();
+	private:
+		const char* name;
+		elm::t::int64 start;
+	};
+
+	Telemetry();
+	inline void enable() { enabled = true; }
+	void reset();
+	inline bool isEnabled() const { return enabled; }
+	inline void count(counter_t c, elm::t::int64 n = 1) { if(enabled) __sync_fetch_and_add(&counters[c], n); }
+	void sample(histogram_t h, elm::t::int64 value);
+	void gauge(const elm::String& name, elm::t::int64 value);
+	void phase(const elm::String& name, elm::t::int64 time_us);
+	void enterCFG();
+	void exitCFG(const elm::String& name, int states, int tops);
+	bool write(const elm::String& file, const elm::String& entry) const;
+	static elm::t::int64 now(); // in µs
+
+private:
+	class Histogram {
+	public:
+		Histogram();
+		elm::t::int64 count, sum, max;
+		elm::t::int64 buckets[BUCKETS];
+	};
+	class CFGRecord {
+	public:
+		elm::String name;
+		elm::t::int64 time_us, self_time_us, blocks, self_blocks;
+		int states, tops;
+	};
+	class Frame { // CFG being analyzed
+	public:
+		elm::t::int64 start, blocks, callee_time_us, callee_blocks;
+	};
+
+	bool enabled;
+	elm::t::int64 counters[COUNTER_COUNT];
+	Histogram histograms[HISTOGRAM_COUNT];
+	elm::genstruct::Vector<elm::Pair<elm::String, elm::t::int64> > gauges, phases;
+	elm::genstruct::Vector<CFGRecord> cfgs;
+	elm::genstruct::Vector<Frame> frames;
+};
+
+extern Telemetry telemetry;
+
+#endif
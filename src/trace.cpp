@@ -0,0 +1,177 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <pthread.h>
+#include <time.h>
+#include <elm/assert.h>
+#include <elm/io/OutFileStream.h>
+#include "trace.h"
+
+using namespace elm;
+
+Trace trace;
+
+static pthread_mutex_t buffers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @class Trace
+ * @brief Chrome trace-event timeline of a run: complete ("X") events, one track per thread
+ */
+Trace::Trace() : enabled(false), origin(0), unslotted(0) { }
+
+Trace::~Trace()
+{
+	for(int i = 0; i < buffers.length(); i++)
+		delete buffers[i];
+}
+
+/**
+ * @fn void Trace::enable();
+ * @brief Start recording, from the main thread, which gets the first track (slot 0)
+ */
+void Trace::enable()
+{
+	origin = now();
+	current() = slot(0);
+	enabled = true;
+}
+
+/**
+ * @fn void Trace::setSlot(int slot);
+ * @brief Record the spans of the current thread on the track of the given slot (1 and above for workers).
+ * Threads on the same slot must not run at the same time, as a worker and the one that replaces it in the next batch.
+ */
+void Trace::setSlot(int slot)
+{
+	ASSERT(slot > 0 && slot < FIRST_UNSLOTTED);
+	if(trace.enabled)
+		current() = trace.slot(slot);
+}
+
+elm::t::int64 Trace::begin()
+{
+	return trace.enabled ? now() - trace.origin : -1;
+}
+
+void Trace::end(const Span& s)
+{
+	Event e;
+	e.cat = s.cat;
+	e.name = s.name;
+	e.label = s.label;
+	e.arg_name = s.arg_name;
+	e.arg = s.arg;
+	e.ts = s.start;
+	e.dur = now() - trace.origin - s.start;
+	trace.local()->events.push(e);
+}
+
+// buffer the current thread records in
+Trace::Buffer*& Trace::current()
+{
+	static __thread Buffer* buffer = NULL;
+	return buffer;
+}
+
+/**
+ * @fn Trace::Buffer* Trace::local();
+ * @brief Buffer of the current thread; a thread that did not pick a slot gets its own track on its first span
+ */
+Trace::Buffer* Trace::local()
+{
+	Buffer*& buffer = current();
+	if(!buffer)
+		buffer = slot(-1);
+	return buffer;
+}
+
+/**
+ * @fn Trace::Buffer* Trace::slot(int slot);
+ * @brief Buffer of a slot, created on first use, or a new buffer if slot is negative
+ */
+Trace::Buffer* Trace::slot(int slot)
+{
+	pthread_mutex_lock(&buffers_mutex);
+	Buffer* buffer = NULL;
+	for(int i = 0; slot >= 0 && i < buffers.length() && !buffer; i++)
+		if(buffers[i]->tid == slot)
+			buffer = buffers[i];
+	if(!buffer)
+	{
+		buffer = new Buffer();
+		buffer->tid = slot >= 0 ? slot : FIRST_UNSLOTTED + unslotted++;
+		buffers.push(buffer);
+	}
+	pthread_mutex_unlock(&buffers_mutex);
+	return buffer;
+}
+
+elm::t::int64 Trace::now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return t::int64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @fn bool Trace::write(const elm::String& file) const;
+ * @brief Write the trace, once all the threads that recorded spans are done
+ * @return false if the file could not be written
+ */
+bool Trace::write(const String& file) const
+{
+	io::OutFileStream stream(file);
+	if(!stream.isReady())
+		return false;
+	io::Output out(stream);
+	out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	bool first = true;
+	for(int b = 0; b < buffers.length(); b++)
+	{
+		const Buffer& buf = *buffers[b];
+		out << (first ? "\n" : ",\n") << "{\"ph\": \"M\", \"pid\": 1, \"tid\": " << buf.tid << ", \"name\": \"thread_name\", \"args\": {\"name\": \"";
+		if(!buf.tid)
+			out << "main";
+		else if(buf.tid < FIRST_UNSLOTTED)
+			out << "worker " << buf.tid;
+		else
+			out << "thread " << buf.tid - FIRST_UNSLOTTED + 1;
+		out << "\"}}";
+		first = false;
+		for(int i = 0; i < buf.events.length(); i++)
+		{
+			const Event& e = buf.events[i];
+			out << ",\n{\"ph\": \"X\", \"pid\": 1, \"tid\": " << buf.tid << ", \"cat\": \"" << e.cat << "\", \"name\": \"";
+			if(e.name)
+				out << e.name;
+			else
+				for(int c = 0; c < e.label.length(); c++) // function names
+					if(e.label[c] != '"' && e.label[c] != '\\' && (unsigned char)e.label[c] >= 0x20)
+						out << e.label[c];
+			out << "\", \"ts\": " << e.ts << ", \"dur\": " << e.dur;
+			if(e.arg_name)
+				out << ", \"args\": {\"" << e.arg_name << "\": " << e.arg << "}";
+			out << "}";
+		}
+	}
+	out << "\n]}\n";
+	return true;
+}
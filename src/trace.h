@@ -0,0 +1,94 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#include <elm/genstruct/Vector.h>
+#include <elm/string/String.h>
+#include <elm/types.h>
+
+/**
+ * Timeline of a run in the Chrome trace-event format (--trace), to be opened in chrome://tracing or Perfetto.
+ * Spans are recorded in a buffer per track, and only gathered when the trace is written at the end of the run.
+ * Worker threads pick their track with setSlot(), so that the workers recreated for each batch of work share one track per index.
+ * Nothing is recorded until enable() is called.
+ */
+class Trace
+{
+public:
+	// span of time from its construction to its destruction, on the current thread
+	class Span {
+	public:
+		inline Span(const char* cat, const char* name, const char* arg_name = NULL, int arg = 0)
+			: cat(cat), name(name), arg_name(arg_name), arg(arg), start(begin()) { }
+		inline Span(const char* cat, const elm::String& label) : cat(cat), name(NULL), label(label), arg_name(NULL), arg(0), start(begin()) { }
+		inline ~Span() { if(start >= 0) end(*this); }
+	private:
+		friend class Trace;
+		const char* cat;
+		const char* name;
+		elm::String label; // instead of name
+		const char* arg_name;
+		int arg;
+		elm::t::int64 start;
+	};
+
+	Trace();
+	~Trace();
+	void enable();
+	inline bool isEnabled() const { return enabled; }
+	static void setSlot(int slot);
+	bool write(const elm::String& file) const;
+
+private:
+	class Event {
+	public:
+		const char* cat;
+		const char* name;
+		elm::String label;
+		const char* arg_name;
+		int arg;
+		elm::t::int64 ts, dur;
+	};
+	class Buffer {
+	public:
+		int tid; // the slot, or FIRST_UNSLOTTED and above for the threads that did not pick one
+		elm::genstruct::Vector<Event> events;
+	};
+	static const int FIRST_UNSLOTTED = 1000;
+
+	static elm::t::int64 begin();
+	static void end(const Span& s);
+	static elm::t::int64 now();
+	static Buffer*& current();
+	Buffer* local();
+	Buffer* slot(int slot);
+
+	bool enabled;
+	elm::t::int64 origin;
+	elm::genstruct::Vector<Buffer*> buffers;
+	int unslotted;
+};
+
+extern Trace trace;
+
+#endif
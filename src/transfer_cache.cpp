@@ -0,0 +1,120 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include "transfer_cache.h"
+#include "struct/var_maker.h"
+
+/**
+ * @class TransferCache
+ * @brief Memoization of State::processBB.
+ * During loop iterations and after joins, states with the same values and labels (modulo the path) often reach the same block again.
+ * Their output values are taken from the cache and only the path of the incoming state is kept.
+ * The labels are part of the match: the edges they name end up in the SMT unsat cores, another path's must not be replayed.
+ * Transfers that introduce new Tops are not recorded: replaying them would identify unknown values from different executions.
+ */
+TransferCache::TransferCache(int capacity) : capacity(capacity), count(0), _lookups(0), _hits(0), first(NULL), last(NULL)
+	{ ASSERT(capacity > 0); }
+
+TransferCache::~TransferCache()
+{
+	for(Entry* e = first; e; )
+	{
+		Entry* next = e->next;
+		delete e;
+		e = next;
+	}
+}
+
+/**
+ * @fn void TransferCache::processBB(const BasicBlock* bb, Analysis::State& s, VarMaker& vm, int flags);
+ * @brief Same as s.processBB(bb, vm, flags), using the cache when possible
+ */
+void TransferCache::processBB(const BasicBlock* bb, Analysis::State& s, VarMaker& vm, int flags)
+{
+	const Key key(bb, s.fingerprint());
+	_lookups++;
+	Entry* e = table.get(key, NULL);
+	if(e && e->in.sameValuesAs(s) && e->in.sameLabelsAs(s)) // the labels of the output come from the input, they must match
+	{
+		_hits++;
+		touch(e);
+		s.copyValuesOf(e->out);
+		DBG("Processing " << (otawa::Block*)bb << ": cached")
+		return;
+	}
+
+	Analysis::State in(s);
+	const int tops = vm.length();
+	s.processBB(bb, vm, flags);
+	if(vm.length() != tops) // new Tops were introduced, this transfer cannot be replayed
+		return;
+	if(e)
+	{	// fingerprint collision, replace the entry
+		e->in = in;
+		e->out = s;
+		touch(e);
+		return;
+	}
+	e = new Entry(key, in, s);
+	table.put(key, e);
+	e->next = first;
+	if(first)
+		first->prev = e;
+	first = e;
+	if(!last)
+		last = e;
+	if(++count > capacity)
+		evict();
+}
+
+// move e to the front of the LRU list
+void TransferCache::touch(Entry* e)
+{
+	if(e == first)
+		return;
+	unlink(e);
+	e->next = first;
+	first->prev = e;
+	first = e;
+}
+
+void TransferCache::unlink(Entry* e)
+{
+	if(e->prev)
+		e->prev->next = e->next;
+	else
+		first = e->next;
+	if(e->next)
+		e->next->prev = e->prev;
+	else
+		last = e->prev;
+	e->prev = e->next = NULL;
+}
+
+// remove the least recently used entry
+void TransferCache::evict()
+{
+	Entry* e = last;
+	unlink(e);
+	table.remove(e->key);
+	delete e;
+	count--;
+}
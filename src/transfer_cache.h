@@ -0,0 +1,73 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _TRANSFER_CACHE_H
+#define _TRANSFER_CACHE_H
+
+#include <elm/genstruct/HashTable.h>
+#include "analysis_state.h"
+
+class VarMaker;
+
+// LRU memo of the transfer function of basic blocks, keyed by (block, fingerprint of the incoming state)
+class TransferCache
+{
+	class Key {
+	public:
+		inline Key(const BasicBlock* bb = NULL, elm::t::hash fp = 0) : bb(bb), fp(fp) { }
+		inline bool operator==(const Key& k) const { return bb == k.bb && fp == k.fp; }
+		inline bool operator!=(const Key& k) const { return !operator==(k); }
+		inline elm::t::hash hash(void) const { return elm::Hasher() << bb << fp; }
+	private:
+		const BasicBlock* bb;
+		elm::t::hash fp;
+	};
+
+	class Entry {
+	public:
+		inline Entry(const Key& key, const Analysis::State& in, const Analysis::State& out)
+			: key(key), in(in), out(out), prev(NULL), next(NULL) { }
+		Key key;
+		Analysis::State in, out;
+		Entry *prev, *next; // LRU list, most recently used first
+	};
+
+public:
+	TransferCache(int capacity);
+	~TransferCache();
+	void processBB(const BasicBlock* bb, Analysis::State& s, VarMaker& vm, int flags);
+
+	inline int lookups() const { return _lookups; }
+	inline int hits() const { return _hits; }
+	inline float hitRate() const { return _lookups ? float(_hits) / float(_lookups) : 0.f; }
+
+private:
+	void touch(Entry* e);
+	void unlink(Entry* e);
+	void evict();
+
+	int capacity, count;
+	int _lookups, _hits;
+	elm::genstruct::HashTable<Key, Entry*, SelfHashKey<Key> > table;
+	Entry *first, *last;
+};
+
+#endif
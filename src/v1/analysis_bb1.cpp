@@ -36,6 +36,7 @@ using namespace otawa::sem;
   */
 void Analysis::State::processSemInst1(const sem::inst& inst, const sem::inst& last_condition)
 {
+	invalidateFingerprint();
 #ifdef V1
 	elm::Pair<const Operand*, const Operand*> opds(NULL, NULL);
 	condoperator_t opr = CONDOPR_EQ; // default is =
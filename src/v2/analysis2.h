@@ -22,7 +22,13 @@
 #ifndef _ANALYSIS2_H
 #define _ANALYSIS2_H
 
+#include <ctime>
+#include "../cfg_snapshot.h"
 #include "../oracle.h"
+#include "../wto.h"
+#include "../transfer_cache.h"
+#include "../liveness.h"
+#include "../summary_cache.h"
 
 class Analysis2 : public DefaultAnalysis, public otawa::Processor
 {
@@ -31,17 +37,31 @@ class Analysis2 : public DefaultAnalysis, public otawa::Processor
 
 	// otawa::Processor inherited methods
 public:
-	Analysis2(AbstractRegistration& _reg = reg) : DefaultAnalysis(), otawa::Processor(_reg) { }
+	Analysis2(AbstractRegistration& _reg = reg) : DefaultAnalysis(), otawa::Processor(_reg), snap(NULL), tcache(NULL), pruned_count(0), scache(NULL), last_summary_checkpoint(0) { }
+	~Analysis2() { delete scache; }
 	static p::declare reg;
 	virtual void configure(const PropList &props) { Processor::configure(props); Analysis::configure(props); }
 
 protected:
-	virtual void processWorkSpace(WorkSpace *ws)  { Analysis::processWorkSpace(ws); }
+	virtual void processWorkSpace(WorkSpace *ws);
 
 	// some private methods
 private:
 	void processCFG(CFG* cfg, bool use_initial_data);
+	bool loadSummary(CFG* cfg, bool use_initial_data);
+	bool processBlock(Block* b, WorkingList* wl);
+	LockPtr<States> joinTraces(const CFGSnapshot::edges_t& ins);
+	inline void setStatus(Block* h, loopheader_status_t ls) { snap->setStatus(h, ls); setLoopStatus(h, ls); } // LH_STATUS is still read by the progress display
+	bool processWTO(CFG* cfg, WorkingList& wl);
+	bool processWTO(const WTO::list_t& components);
 	void I(Block* b, LockPtr<States> s);
+
+	CFGSnapshot* snap; // snapshot of the CFG being processed
+	TransferCache* tcache; // optional memo of basic block transfers
+	int pruned_count; // dead entries pruned from states
+	SummaryCache* scache; // optional store of function summaries
+	IPStats cfg_ip_stats; // infeasible paths found in the CFG being processed
+	std::time_t last_summary_checkpoint;
 };
 
 #endif
\ No newline at end of file
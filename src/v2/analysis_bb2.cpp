@@ -38,17 +38,18 @@ using namespace otawa::sem;
  * @brief      v2/v3 of abstract interpretation
  *
  * @param inst  The semantic instruction to parse
+ * @param is_cond  True if the instruction starts a conditional segment (see sem::PathIter::isCond)
  * @return 	    0 by default, 1 if memory needs to be wiped
  */
-int Analysis::State::SemanticParser::process(const sem::PathIter& inst)
+int Analysis::State::SemanticParser::process(const sem::inst& inst, bool is_cond)
 {
 	const t::int16 &a = inst.a(), &b = inst.b(), &d = inst.d();
 	const t::int32 &cst = inst.cst();
 	const t::int16 &reg = inst.reg(), &addr = inst.addr();
-	const t::uint16 op = inst.op();
+	const t::uint16 op = inst.op;
 	const bool in_conditional_segment = (lastCond().op != NOP);
 
-	if(inst.isCond())
+	if(is_cond)
 		last_condition = inst;
 
 	// parse conservatively conditional segments of the BB: set top to everything that is written there
@@ -101,7 +102,7 @@ int Analysis::State::SemanticParser::process(const sem::PathIter& inst)
 			if(lvars.isConst(addr))
 			{
 				Constant c = lvars(addr).toConstant();
-				if(Option<Constant> v = s.getConstantValueOfReadOnlyMemCell(OperandMem(c), (*inst).type()))
+				if(Option<Constant> v = s.getConstantValueOfReadOnlyMemCell(OperandMem(c), inst.type()))
 				{
 					DBG(color::IBlu() << "  R-O memory cell " << OperandMem(c) << " simplified to " << *v)
 					set(reg, dag.cst(*v));
@@ -267,6 +268,7 @@ int Analysis::State::SemanticParser::process(const sem::PathIter& inst)
  */
 void Analysis::State::set(const OperandVar& x, const Operand* expr, bool set_updated)
 {
+	invalidateFingerprint();
 	DBG(color::IGre() << " * " << x << " = " << *expr << color::Gre() << " {" << lvars(x) << "}")
 	lvars[x] = expr;
 	if(set_updated)
@@ -281,6 +283,7 @@ void Analysis::State::set(const OperandVar& x, const Operand* expr, bool set_upd
  */
 void Analysis::State::setMem(Constant addr, const Operand* expr)
 {
+	invalidateFingerprint();
 	DBG(color::IGre() << " * " << OperandMem(addr) << " = " << *expr
 		<< color::Gre() << " {" << (mem.exists(addr) ? **mem[addr] : (const Operand&)OperandMem(addr)) << "}")
 	mem[addr] = expr;
@@ -327,6 +330,7 @@ const Operand* Analysis::State::getPtr(t::int32 var_id) const
  */
 void Analysis::State::wipeMemory(VarMaker& vm)
 {
+	invalidateFingerprint();
 	DBG(color::IRed() << "  Wiping the memory (" << mem.count() << " items)")
 	mem.clear();
 
@@ -377,6 +381,44 @@ void Analysis::State::clampPredicates(VarMaker &vm)
 	// for(MutablePredIterator piter(*this); piter; piter++)
 }
 
+/**
+ * @brief      Drop the values that cannot be read anymore: dead registers, and stack cells below SP
+ *
+ * @param      live  The registers live at this point (see Liveness)
+ * @return     The number of pruned entries
+ */
+int Analysis::State::pruneDead(const BitVector& live)
+{
+	int count = 0;
+	for(int r = 0; r < lvars.maxRegisters(); r++)
+		if(lvars[r] && !live.bit(r) && r != context->sp.addr())
+		{
+			DBG(color::IYel() << "  Pruning dead " << OperandVar(r) << " = " << *lvars[r])
+			lvars[r] = NULL; // the value of r is overwritten on all paths before being read
+			lvars.clearLabels(r);
+			count++;
+		}
+
+	const Operand& sp = lvars(context->sp);
+	if(sp.kind() == CST && sp.toConstant().isRelativePositive())
+	{
+		const Constant spv = sp.toConstant();
+		Vector<Constant> todel;
+		for(mem_t::PairIterator iter(mem); iter; iter++)
+			if((*iter).fst.isRelativePositive() && (*iter).fst.val() < spv.val())
+				todel.push((*iter).fst);
+		for(Vector<Constant>::Iter i(todel); i; i++)
+		{
+			DBG(color::IYel() << "  Pruning " << OperandMem(*i) << " (below SP)")
+			mem.remove(*i);
+		}
+		count += todel.length();
+	}
+	if(count)
+		invalidateFingerprint();
+	return count;
+}
+
 void Analysis::State::updateLabels(const sem::inst& seminst)
 {
 	switch(seminst.op)
@@ -30,6 +30,8 @@
 #include "../progress.h"
 #include "../assert_predicate.h"
 #include "../struct/var_maker.h"
+#include "../telemetry.h"
+#include "../trace.h"
 
 using namespace elm::io;
 
@@ -43,6 +45,52 @@ p::declare Analysis2::reg = p::init("otawa::pathfinder::pathfinder", Version(2,
 	.require(LOOP_INFO_FEATURE)
 	.provide(INFEASIBLE_PATHS_FEATURE);
 
+/**
+ * @fn void Analysis2::processWorkSpace(WorkSpace *ws);
+ * @brief Run the analysis, with a transfer cache if one was requested, then report the optimization stats
+ * When the summaries are resident, this may be called again on the same workspace for another entry or other options.
+*/
+void Analysis2::processWorkSpace(WorkSpace *ws)
+{
+	for(CFGCollection::Iter cfg(INVOLVED_CFGS(ws)); cfg; cfg++)
+	{	// summaries of a previous run are not trusted as is, they are reloaded through the resident cache
+		CFG_S.remove(*cfg);
+		CFG_VARS.remove(*cfg);
+	}
+	pruned_count = 0;
+	last_summary_checkpoint = std::time(NULL);
+	if(scache)
+		scache->reset(ws, flags, state_size_limit);
+	if(transfer_cache_size > 0 && version() > 1)
+		tcache = new TransferCache(transfer_cache_size);
+	Analysis::processWorkSpace(ws);
+	if(tcache)
+	{
+		telemetry.count(Telemetry::TRANSFER_CACHE_LOOKUPS, tcache->lookups());
+		telemetry.count(Telemetry::TRANSFER_CACHE_HITS, tcache->hits());
+		if(dbg_verbose < DBG_VERBOSE_NONE && !(dbg_flags&DBG_DETERMINISTIC))
+			cout << "Transfer cache: " << tcache->hits() << "/" << tcache->lookups() << " hits ("
+				 << int(tcache->hitRate() * 100.f) << "%)" << endl;
+		delete tcache;
+		tcache = NULL;
+	}
+	if((flags&LIVENESS_PRUNING) && dbg_verbose < DBG_VERBOSE_NONE)
+		cout << "Liveness: pruned " << pruned_count << " dead entries" << endl;
+	if(scache)
+	{
+		telemetry.count(Telemetry::SUMMARY_CACHE_HITS, scache->hits());
+		telemetry.count(Telemetry::SUMMARY_CACHE_MISSES, scache->misses());
+		telemetry.count(Telemetry::SUMMARY_CACHE_STORES, scache->stores());
+		if(dbg_verbose < DBG_VERBOSE_NONE)
+			cout << "Summary cache: " << scache->hits() << " loaded, " << scache->misses() << " computed, " << scache->stores() << " stored" << endl;
+		if(!resident_summaries)
+		{
+			delete scache;
+			scache = NULL;
+		}
+	}
+}
+
 /**
  * @fn void Analysis2::processCFG(Block* entry);
  * @brief Runs the analysis with no virtualization
@@ -50,13 +98,34 @@ p::declare Analysis2::reg = p::init("otawa::pathfinder::pathfinder", Version(2,
 void Analysis2::processCFG(CFG* cfg, bool use_initial_data)
 {
 	ASSERT(! (flags&VIRTUALIZE_CFG));
+	Trace::Span span("cfg", cfg->name());
 	DBGG(IPur() << "==>\"" << cfg->name() << "\"")
+	if((!summary_cache_path.isEmpty() || resident_summaries || !summary_checkpoint.isEmpty()) && !scache) // created on first use, once the context is known
+	{	// summary checkpoints are snapshots of what the resident cache holds
+		scache = new SummaryCache(summary_cache_path, workspace(), context, dag, flags, state_size_limit, resident_summaries || !summary_checkpoint.isEmpty());
+		if(resume_summaries)
+		{
+			const int n = scache->resume(summary_checkpoint, INVOLVED_CFGS(workspace())->get(0));
+			if(n < 0)
+				cerr << "Could not load the summaries of " << summary_checkpoint << " (missing, or taken from another analysis), starting over" << endl;
+			else if(dbg_verbose < DBG_VERBOSE_NONE)
+				cout << "Loaded the summaries of " << summary_checkpoint << " (" << n << " summaries)" << endl;
+		}
+	}
+	if(scache && loadSummary(cfg, use_initial_data))
+		return;
 	if(flags&SHOW_PROGRESS)
 		progress->enter(cfg);
+	telemetry.enterCFG();
 	
 	WorkingList wl;
+	const IPStats ip_stats_backup = cfg_ip_stats;
+	cfg_ip_stats = IPStats();
 	const LockPtr<VarMaker> vm_backup = vm;
 	vm = LockPtr<VarMaker>(new VarMaker());
+	CFGSnapshot* const snap_backup = snap;
+	CFGSnapshot g(cfg);
+	snap = &g;
 /* begin */
 	/* for e ∈ E(G) */
 		/* s_e ← nil */
@@ -64,101 +133,24 @@ void Analysis2::processCFG(CFG* cfg, bool use_initial_data)
 		/* s_h ← nil */
 		/* status_h ← ENTER */
 	/* for e ∈ entry.outs */
-	for(Block::EdgeIter e(cfg->entry()->outs()); e; e++)
+	const CFGSnapshot::edges_t entry_outs = g.outs(cfg->entry());
+	for(int i = 0; i < entry_outs.count(); i++)
 	{
 		/* s_e ← T */
 		LockPtr<States> s_entry(new States());
 		s_entry->push(topState(cfg->entry()));
 		if(use_initial_data)
 			s_entry->states()[0].initializeWithDFA();
-		EDGE_S(*e) = s_entry;
+		g.trace(entry_outs[i]) = s_entry;
 		/* wl ← sink(e) */
-		wl.push((*e)->target()); // only one outs, firstBB.
+		wl.push(g.edge(entry_outs[i])->target()); // only one outs, firstBB.
 	}
 
-	/* while wl ≠ {} do */
-	while(!wl.isEmpty())
-	{
-		/* b ← pop(wl) */
-		Block *b = wl.pop();
-		/* pred ← 	b.ins \ B(G) if b ∈ H(G) ∧ status_b = ENTER */
-		/* 			b.ins ∩ B(G) if b ∈ H(G) ∧ status_b ∈ {FIX, ACCEL, LEAVE} */
-		/* 			b.ins 		 if b ∈/ H(G) */
-		const Vector<Edge*> pred(LOOP_HEADER(b) ? (loopStatus(b) == ENTER
-				? nonBackIns(b) /* if b ∈ H(G) ∧ status_b = ENTER */
-				: backIns(b) /* if b ∈ H(G) ∧ status_b ∈ {FIX, ACCEL, LEAVE} */
-			) : allIns(b) /* if b ∉ H(G) */
-		);
-
-		if(allEdgesHaveTrace(pred)) /* if ∀e ∈ pred, s_e ≠ nil then */
-		{
-			LockPtr<States> s = join(pred); /* s ← |_|e∈pred s_e */
-
-			for(Vector<Edge*>::Iter e(pred); e; e++) /* for e ∈ pred */
-				EDGE_S.remove(e); /* s_e ← nil */
-			
-			bool propagate = true; /* succ ← b.outs */
-			if(LOOP_HEADER(b)) /* if b ∈ H(G) then */
-			{
-				if(loopStatus(b) == FIX)
-					s->push(LH_S(b)); /* s ← s ∪ s_b */
-				s = merge(s, b);
-
-				switch(loopStatus(b))
-				{
-					case ENTER:
-						setLoopStatus(b, FIX); /* status_b ← FIX if status_b = ENTER */
-						LH_S0(b) = s->one();
-						break;
-
-					case FIX:
-						if(s->one().equiv(LH_S(b)))
-						{
-							setLoopStatus(b, ACCEL); /* status_b ← ACCEL if status_b = FIX ∧ s ≡ s_b */
-							s->prepareFixPoint();
-						}
-						break;
-
-					case ACCEL:
-						setLoopStatus(b, LEAVE); /* status_b ← LEAVE if status_b = ACCEL */
-						s->widening(newLoopIterOpd(b));
-						s->appliedTo(LH_S0(b), *vm);
-						break;
-
-					case LEAVE:
-						setLoopStatus(b, ENTER); /* status_b ← ENTER if status_b = LEAVE */
-						if(anyEdgeHasTrace(b->ins())) /* if ∃e ∈ b.ins | s_e =/ nil then */
-							wl.push(b); /* wl ← wl ∪ {b} */
-						propagate = false; /* succ ← {} */
-						break;
-				}
-
-				if(loopStatus(b) == LEAVE) /* if status_b == LEAVE */
-					LH_S.remove(b); /* s_b ← nil */
-				else
-					LH_S(b) = s->one(); /* s_b ← s */
-			}
-			I(b, s); // update s (opti)
-			/* for e ∈ succ \ {EX_h | b ∈ L_h ∧ status_h =/ LEAVE} */
-			const Vector<Edge*> succ(propagate ? outsWithoutUnallowedExits(b) : nullVector<Edge*>());
-			for(Vector<Edge*>::Iter e(succ); e; e++)
-			{
-				/* s_e ← I*[e](s) */
-				EDGE_S(e) = Analysis::I(e, s);
-				for(LoopExitIterator l(*e); l; l++)
-					EDGE_S(e)->finalizeLoop(LH_I(*l), *vm);
-
-				if(BACK_EDGE(e) && loopStatus(e->target()) == LEAVE)
-					s->printLoopBoundOf(LH_I(e->target()));
-
-				/* ips ← ips ∪ ipcheck(s_e , {(h, status_h ) | b ∈ L_h }) */
-				if(inD_ip(e))
-					ip_stats += ipcheck(*EDGE_S.ref(e), infeasible_paths);
-				/* wl ← wl ∪ {sink(e)} */
-				wl.push(outsAlias(e->sink()));
-			}
-		}
-	}
+	if(!(flags&WTO_ITERATION) || !processWTO(cfg, wl))
+		/* while wl ≠ {} do */
+		while(!wl.isEmpty())
+			/* b ← pop(wl) */
+			processBlock(wl.pop(), &wl);
 /* end */
 	// Pretty printing
 	if(flags & SHOW_PROGRESS)
@@ -170,12 +162,237 @@ void Analysis2::processCFG(CFG* cfg, bool use_initial_data)
 	CFG_S(cfg)->minimize(*vm, flags&CLEAN_TOPS); // reduces the VarMaker to the minimum
 	CFG_S(cfg)->removeTautologies();
 	CFG_VARS(cfg) = vm;
+	telemetry.exitCFG(cfg->name(), CFG_S(cfg)->count(), vm->sizes().fst);
 	vm = vm_backup;
+	snap = snap_backup;
 	// Check all sp are valid
 	ASSERTP(elm::forall(States::Iter(**CFG_S(cfg)), SPCanEqual(), static_cast<const OperandConst*>(dag->cst(SP))), context.sp << " is definitely not SP+0. " << Dim() << "(" << cfg->name() << ")" << RCol());
 	// Reset SP if it got scratch'd
 	if(flags&ASSUME_IDENTICAL_SP)
 		CFG_S(cfg)->resetSP();
+	if(scache)
+	{
+		Vector<DetailedPath> ips;
+		for(int i = 0; i < infeasible_paths.count(); i++)
+			if(infeasible_paths[i].function() == cfg)
+				ips.push(infeasible_paths[i]);
+		scache->save(cfg, use_initial_data, **CFG_S(cfg), **CFG_VARS(cfg), cfg_ip_stats, ips);
+		if(!summary_checkpoint.isEmpty() && std::time(NULL) - last_summary_checkpoint >= summary_checkpoint_interval)
+		{
+			if(!scache->checkpoint(summary_checkpoint, INVOLVED_CFGS(workspace())->get(0)))
+				cerr << "Could not write the summary checkpoint " << summary_checkpoint << endl;
+			last_summary_checkpoint = std::time(NULL);
+		}
+	}
+	cfg_ip_stats = ip_stats_backup;
+}
+
+/**
+ * @fn bool Analysis2::loadSummary(CFG* cfg, bool use_initial_data);
+ * @brief Use the stored summary of a CFG instead of analyzing it, if there is one
+ * @return true if the summary was loaded
+ */
+bool Analysis2::loadSummary(CFG* cfg, bool use_initial_data)
+{
+	LockPtr<States> s;
+	LockPtr<VarMaker> cfg_vm;
+	IPStats stats;
+	Vector<DetailedPath> ips;
+	if(!scache->load(cfg, use_initial_data, s, cfg_vm, stats, ips))
+		return false;
+	DBGG(IPur() << "<==\"" << cfg->name() << "\" (summary loaded, " << s->count() << " states, " << ips.count() << " infeasible paths)")
+	CFG_S(cfg) = s;
+	CFG_VARS(cfg) = cfg_vm;
+	ip_stats += stats;
+	for(Vector<DetailedPath>::Iter ip(ips); ip; ip++)
+		addDetailedInfeasiblePath(*ip, infeasible_paths);
+	// the callees are not visited through this CFG anymore, their own infeasible paths must still be found
+	for(CFG::BlockIter b(cfg->blocks()); b; b++)
+		if(b->isCall() && b->toSynth()->callee() && !CFG_S.exists(b->toSynth()->callee()))
+			processCFG(b->toSynth()->callee(), false);
+	return true;
+}
+
+/**
+ * @fn bool Analysis2::processBlock(Block* b, WorkingList* wl);
+ * @brief Fixpoint step on a block: join the incoming states, update the loop status and propagate to the successors
+ * @param b The block to process
+ * @param wl Working list to push the successors to, or NULL if the iteration order is handled by the caller (WTO)
+ * @return false if some incoming edges had no trace yet, so the block could not be processed
+ */
+bool Analysis2::processBlock(Block* b, WorkingList* wl)
+{
+	CFGSnapshot& g = *snap;
+	if(dbg_verbose < DBG_VERBOSE_RESULTS_ONLY) cout << endl;
+	DBGG("-" << color::ICya() << b << color::RCol() << " " << printFixPointStatus(b))
+	/* pred ← 	b.ins \ B(G) if b ∈ H(G) ∧ status_b = ENTER */
+	/* 			b.ins ∩ B(G) if b ∈ H(G) ∧ status_b ∈ {FIX, ACCEL, LEAVE} */
+	/* 			b.ins 		 if b ∈/ H(G) */
+	const CFGSnapshot::edges_t pred(g.isLoopHeader(b) ? (g.status(b) == ENTER
+			? g.nonBackIns(b) /* if b ∈ H(G) ∧ status_b = ENTER */
+			: g.backIns(b) /* if b ∈ H(G) ∧ status_b ∈ {FIX, ACCEL, LEAVE} */
+		) : g.allIns(b) /* if b ∉ H(G) */
+	);
+
+	if(g.allHaveTrace(pred)) /* if ∀e ∈ pred, s_e ≠ nil then */
+	{
+		LockPtr<States> s = joinTraces(pred); /* s ← |_|e∈pred s_e */
+		telemetry.count(Telemetry::BLOCKS_PROCESSED);
+
+		for(int i = 0; i < pred.count(); i++) /* for e ∈ pred */
+			g.removeTrace(pred[i]); /* s_e ← nil */
+		
+		bool propagate = true; /* succ ← b.outs */
+		if(g.isLoopHeader(b)) /* if b ∈ H(G) then */
+		{
+			if(g.status(b) == FIX)
+				s->push(LH_S(b)); /* s ← s ∪ s_b */
+			s = merge(s, b);
+
+			switch(g.status(b))
+			{
+				case ENTER:
+					setStatus(b, FIX); /* status_b ← FIX if status_b = ENTER */
+					LH_S0(b) = s->one();
+					break;
+
+				case FIX:
+					if(s->one().equiv(LH_S(b)))
+					{
+						setStatus(b, ACCEL); /* status_b ← ACCEL if status_b = FIX ∧ s ≡ s_b */
+						s->prepareFixPoint();
+					}
+					break;
+
+				case ACCEL:
+					setStatus(b, LEAVE); /* status_b ← LEAVE if status_b = ACCEL */
+					s->widening(newLoopIterOpd(b));
+					s->appliedTo(LH_S0(b), *vm);
+					break;
+
+				case LEAVE:
+					setStatus(b, ENTER); /* status_b ← ENTER if status_b = LEAVE */
+					if(wl && g.anyHasTrace(g.allIns(b))) /* if ∃e ∈ b.ins | s_e =/ nil then */
+						wl->push(b); /* wl ← wl ∪ {b} */
+					propagate = false; /* succ ← {} */
+					break;
+			}
+
+			if(g.status(b) == LEAVE) /* if status_b == LEAVE */
+				LH_S.remove(b); /* s_b ← nil */
+			else
+				LH_S(b) = s->one(); /* s_b ← s */
+		}
+		I(b, s); // update s (opti)
+		/* for e ∈ succ \ {EX_h | b ∈ L_h ∧ status_h =/ LEAVE} */
+		const CFGSnapshot::edges_t succ(propagate ? g.outsWithoutUnallowedExits(b) : CFGSnapshot::edges_t(NULL, 0));
+		for(int i = 0; i < succ.count(); i++)
+		{
+			Edge* e = g.edge(succ[i]);
+			DBGG(color::Bold() << "\t\t->" << color::RCol() << e->target())
+			/* s_e ← I*[e](s) */
+			LockPtr<States>& s_e = g.trace(succ[i]);
+			s_e = Analysis::I(e, s, true);
+			const CFGSnapshot::loops_t exited = g.exitedLoops(succ[i]);
+			for(int l = 0; l < exited.count(); l++)
+				s_e->finalizeLoop(LH_I(exited[l]), *vm);
+			telemetry.sample(Telemetry::STATES_PER_EDGE, s_e->count());
+
+			if(g.isBack(succ[i]) && g.status(e->target()) == LEAVE)
+				s->printLoopBoundOf(LH_I(e->target()));
+
+			/* ips ← ips ∪ ipcheck(s_e , {(h, status_h ) | b ∈ L_h }) */
+			if(b->isCall() || (g.isConditional(b) && g.allLoopsLeave(b))) // inD_ip(e)
+			{
+				const IPStats stats = ipcheck(*s_e, infeasible_paths);
+				ip_stats += stats;
+				cfg_ip_stats += stats;
+			}
+			/* wl ← wl ∪ {sink(e)} */
+			if(wl)
+				wl->push(outsAlias(e->sink()));
+		}
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @fn LockPtr<States> Analysis2::joinTraces(const CFGSnapshot::edges_t& ins);
+ * @brief Join the traces of a set of edges of the current CFG, merging if the result is too large
+ */
+LockPtr<Analysis::States> Analysis2::joinTraces(const CFGSnapshot::edges_t& ins)
+{
+	ASSERTP(!ins.isEmpty(), "join given empty ingoing edges vector")
+	LockPtr<States> v;
+	if(ins.count() == 1) // opti
+		v = snap->trace(ins[0]);
+	else
+	{
+		v = LockPtr<States>(new States());
+		for(int i = 0; i < ins.count(); i++)
+			v->states().addAll(snap->trace(ins[i])->states());
+	}
+	v->collapseDuplicates();
+	if((flags&MERGE) && v->count() > state_size_limit) // check for too large states
+		v = merge(v, snap->edge(ins[0])->target());
+	return v;
+}
+
+/**
+ * @fn bool Analysis2::processWTO(CFG* cfg, WorkingList& wl);
+ * @brief Runs the fixpoint of a CFG following its weak topological order, stabilizing each loop component recursively
+ * @return false if the working list strategy must finish the fixpoint: either the WTO is not compatible with the loop headers
+ *  of the CFG (irreducible loops) and nothing was done, or a loop header could not be processed in WTO order,
+ *  and wl now holds the blocks that have pending states
+ */
+bool Analysis2::processWTO(CFG* cfg, WorkingList& wl)
+{
+	WTO wto(cfg);
+	if(!wto.isValid())
+	{
+		DBGW("WTO of " << cfg->name() << " does not match its loop headers, using the working list")
+		return false;
+	}
+	DBG("WTO of " << cfg->name() << ": " << wto)
+	if(processWTO(wto.components()))
+		return true;
+	while(!wl.isEmpty()) // the entry pushed by processCFG was already processed
+		wl.pop();
+	for(CFG::BlockIter b(cfg->blocks()); b; b++)
+		if(!b->isEntry() && snap->anyHasTrace(snap->allIns(*b)))
+			wl.push(*b);
+	return false;
+}
+
+/**
+ * @fn bool Analysis2::processWTO(const WTO::list_t& components);
+ * @brief Process a list of WTO components, stabilizing the loops
+ * @return false if a loop header could not be processed, the rest of the CFG is then left to the working list
+ */
+bool Analysis2::processWTO(const WTO::list_t& components)
+{
+	for(WTO::list_t::Iterator c(components); c; c++)
+	{
+		Block* h = (*c)->head();
+		if(h->isEntry()) // entry edges are initialized by processCFG
+			continue;
+		if(!processBlock(h, NULL) || !(*c)->isLoop())
+			continue;
+		/* ENTER → FIX → ... → ACCEL → LEAVE → ENTER: stabilize the component */
+		while(snap->status(h) != ENTER)
+		{
+			if(!processWTO((*c)->body()))
+				return false;
+			if(!processBlock(h, NULL))
+			{
+				cerr << "WARNING: loop header " << h << " of " << h->cfg()->name() << " could not be stabilized in WTO order, "
+					"finishing with the working list" << endl;
+				return false;
+			}
+		}
+	}
+	return true;
 }
 
 /**
@@ -183,13 +400,26 @@ void Analysis2::processCFG(CFG* cfg, bool use_initial_data)
  */
 void Analysis2::I(Block* b, LockPtr<States> s)
 {
+	Trace::Span span("block", "I", "block", b->index());
 	if(flags&SHOW_PROGRESS)
 		progress->onBlock(b);
 	if(b->isBasic())
 	{
 		DBGG(Bold() << "-\tI(b=" << b << ") " << NoBold() << IYel() << "x" << s->count() << RCol() << printFixPointStatus(b))
+		telemetry.count(Telemetry::PROCESS_BB, s->count());
 		for(States::Iter si(s->states()); si; si++)
-			(*s)[si].processBB(b->toBasic(), *vm, flags);
+		{
+			if(tcache)
+				tcache->processBB(b->toBasic(), (*s)[si], *vm, flags);
+			else
+				(*s)[si].processBB(b->toBasic(), *vm, flags);
+		}
+		if(flags&LIVENESS_PRUNING)
+		{
+			const BitVector& live = Liveness::of(b->cfg(), context.max_registers).liveOut(b);
+			for(States::Iter si(s->states()); si; si++)
+				pruned_count += (*s)[si].pruneDead(live);
+		}
 	}
 	else if(b->isEntry())
 		s->onCall((*getCaller(b->cfg()))->toSynth());
@@ -26,8 +26,7 @@ class Analysis::State::SemanticParser
 {	// TODO: make it act like an Iterator, and make a SemanticParser for v1 too
 public:
 	SemanticParser(State& s, VarMaker& vm) : s(s), vm(vm), lvars(s.lvars), dag(*s.dag), last_condition(sem::NOP) { }
-	int process(const sem::PathIter& seminsts);
-	// int process(sem::inst inst);
+	int process(const sem::inst& inst, bool is_cond);
 	inline void set(const OperandVar& var, const Operand* expr, bool set_updated = true) { s.set(var, expr, set_updated); }
 	inline void setMem(Constant addr, const Operand* expr) { s.setMem(addr, expr); }
 	int store(OperandVar addr, const Operand* b);
@@ -26,6 +26,7 @@
 #include "struct/operand.h"
 
 // rolls back an iter
+// like the Compositor, the result of each OperandArith node is memoized
 class RollerBack : public OperandEndoVisitor
 {
 public:
@@ -36,10 +37,17 @@ public:
 	const Operand* visit(const class OperandTop& g)  { return &g; }
 	const Operand* visit(const class OperandIter& g) { return Arith::add(dag, Constant(-1), static_cast<const Operand*>(&g)); }
 	const Operand* visit(const class OperandArith& g)
-		{ return Arith::autoOp(dag, g.opr(), g.leftOperand().accept(*this), g.isBinary() ? g.rightOperand().accept(*this) : NULL); }
+	{
+		if(const Operand* r = memo.get(&g, NULL))
+			return r;
+		const Operand* r = Arith::autoOp(dag, g.opr(), staticEndoAccept(g.leftOperand(), *this), g.isBinary() ? staticEndoAccept(g.rightOperand(), *this) : NULL);
+		memo.put(&g, r);
+		return r;
+	}
 private:
 	DAG& dag;
 	const Operand* opdi;
+	genstruct::HashTable<const Operand*, const Operand*> memo;
 };
 
 // Widenor: a class for State composition
@@ -51,23 +59,29 @@ public:
 	// self is the operand that should not be replaced, n is the OperandIter
 	Widenor(const Analysis::State& s, const Operand* self, const Operand* n)
 		: dag(s.getDag()), lvars(s.getLocalVariables()), mem(s.getMemoryTable()), self(self), rollback(dag, n) { }
-	void setSelf(const Operand* x) { self = x; }
+	void setSelf(const Operand* x) { self = x; memo.clear(); } // the results depend on self
 
 	const Operand* visit(const class OperandConst& g) { return &g; }
 	const Operand* visit(const class OperandVar& g) { 
 		if(g == *self)
 			return &g;
-		return lvars[g] ? lvars[g]->accept(rollback) : dag.var(g); // we need to (smartly) replace I by I-1
+		return lvars[g] ? staticEndoAccept(*lvars[g], rollback) : dag.var(g); // we need to (smartly) replace I by I-1
 	}
 	const Operand* visit(const class OperandMem& g)  { 
 		if(g == *self)
 			return &g;
-		return (*mem[g.addr()])->accept(rollback); // we need to (smartly) replace I by I-1
+		return staticEndoAccept(**mem[g.addr()], rollback); // we need to (smartly) replace I by I-1
 	}
 	const Operand* visit(const class OperandTop& g)  { return &g; }
 	const Operand* visit(const class OperandIter& g) { return &g; }
 	const Operand* visit(const class OperandArith& g)
-		{ return Arith::autoOp(dag, g.opr(), g.leftOperand().accept(*this), g.isBinary() ? g.rightOperand().accept(*this) : NULL); }
+	{
+		if(const Operand* r = memo.get(&g, NULL))
+			return r;
+		const Operand* r = Arith::autoOp(dag, g.opr(), staticEndoAccept(g.leftOperand(), *this), g.isBinary() ? staticEndoAccept(g.rightOperand(), *this) : NULL);
+		memo.put(&g, r);
+		return r;
+	}
 
 private:
 	DAG& dag;
@@ -76,6 +90,7 @@ private:
 	// WARNING: this self doesn't come from the DAG, so do not compare pointers! We just need to be able to change it and references don't do that...
 	const Operand* self; // do not replace this one
 	RollerBack rollback;
+	genstruct::HashTable<const Operand*, const Operand*> memo; // valid for the current self only
 };
 
 #endif
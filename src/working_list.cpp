@@ -0,0 +1,208 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include "working_list.h"
+#include "debug.h"
+#include "pretty_printing.h"
+
+/**
+ * @class WorkingList
+ * @author Jordy Ruiz
+ * @brief Priority queue of blocks to process, with the deepest loop levels first
+ */
+WorkingList::~WorkingList()
+{
+	for(genstruct::HashTable<CFG*, CFGKeys*>::Iterator iter(tables); iter; iter++)
+		delete *iter;
+}
+
+/**
+ * @fn Block* WorkingList::pop(void);
+ * @brief Remove and return the block with the highest priority
+ */
+Block* WorkingList::pop(void)
+{
+	if(dbg_verbose == DBG_VERBOSE_ALL)
+		DBG("popping from " << toString())
+	ASSERT(!heap.isEmpty());
+	Block* b = heap[0].b;
+	keysOf(b->cfg()).in.clear(b->index());
+	heap[0] = heap.top();
+	heap.pop();
+	if(!heap.isEmpty())
+		down(0);
+	return b;
+}
+
+/**
+ * @fn void WorkingList::push(Block* b);
+ * @brief Add a block to the working list, if it is not already in it
+ */
+void WorkingList::push(Block* b)
+{
+	CFGKeys& k = keysOf(b->cfg());
+	if(k.in.bit(b->index()))
+		return;
+	k.in.set(b->index());
+	item_t item = { k.keys[b->index()], b };
+	heap.push(item);
+	up(heap.length()-1);
+}
+
+elm::String WorkingList::toString(void) const
+{
+	// list the blocks in priority order, on a copy of the heap
+	WorkingList copy;
+	for(int i = 0; i < heap.length(); i++)
+		copy.heap.push(heap[i]);
+	elm::String rtn = "[";
+	bool first = true;
+	while(!copy.heap.isEmpty())
+	{
+		if(first) first = false; else
+			rtn = rtn.concat(CString(", "));
+		rtn = _ << rtn << copy.heap[0].b;
+		copy.heap[0] = copy.heap.top();
+		copy.heap.pop();
+		if(!copy.heap.isEmpty())
+			copy.down(0);
+	}
+	rtn = rtn.concat(CString("]"));
+	return rtn;
+}
+
+/**
+ * @brief Priority test: true if k1 must be processed before k2
+ */
+bool WorkingList::before(const key_t& k1, const key_t& k2)
+{
+	if(k1.depth != k2.depth)
+		return k1.depth > k2.depth; // deeper loop first
+	if(k1.nest_cfg != k2.nest_cfg)
+		return k1.nest_cfg < k2.nest_cfg;
+	if(k1.nest != k2.nest)
+		return k1.nest < k2.nest;
+	if(k1.cfg != k2.cfg)
+		return k1.cfg < k2.cfg;
+	return k1.rpo < k2.rpo;
+}
+
+WorkingList::CFGKeys& WorkingList::keysOf(CFG* cfg)
+{
+	if(cfg == last_cfg)
+		return *last_keys;
+	CFGKeys* k = tables.get(cfg, NULL);
+	if(!k)
+	{
+		k = new CFGKeys(cfg);
+		tables.put(cfg, k);
+	}
+	last_cfg = cfg;
+	last_keys = k;
+	return *k;
+}
+
+void WorkingList::up(int i)
+{
+	item_t item = heap[i];
+	while(i > 0)
+	{
+		int parent = (i-1) / 2;
+		if(!before(item.key, heap[parent].key))
+			break;
+		heap[i] = heap[parent];
+		i = parent;
+	}
+	heap[i] = item;
+}
+
+void WorkingList::down(int i)
+{
+	item_t item = heap[i];
+	const int n = heap.length();
+	for(int child = 2*i+1; child < n; child = 2*i+1)
+	{
+		if(child+1 < n && before(heap[child+1].key, heap[child].key))
+			child++;
+		if(!before(heap[child].key, item.key))
+			break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = item;
+}
+
+/**
+ * @brief Compute the ordering keys of all the blocks of a CFG
+ */
+WorkingList::CFGKeys::CFGKeys(CFG* cfg) : keys(cfg->count()), in(cfg->count())
+{
+	const int n = cfg->count();
+	key_t def = { 0, -1, -1, cfg->index(), 0 };
+	for(int i = 0; i < n; i++)
+		keys.push(def);
+
+	// reverse postorder: iterative DFS from the entry
+	elm::BitVector done(n);
+	genstruct::Vector<Block*> stack;
+	int post = n;
+	stack.push(cfg->entry());
+	done.set(cfg->entry()->index());
+	while(!stack.isEmpty())
+	{
+		Block* b = stack.top();
+		bool all_done = true;
+		for(Block::EdgeIter e(b->outs()); e; e++)
+		{
+			Block* w = e->target();
+			if(w->cfg() == cfg && !done.bit(w->index()))
+			{
+				done.set(w->index());
+				stack.push(w);
+				all_done = false;
+				break;
+			}
+		}
+		if(all_done)
+		{
+			keys[b->index()].rpo = --post;
+			stack.pop();
+		}
+	}
+	// unreachable blocks go last
+	for(int i = 0; i < n; i++)
+		if(!done.bit(i))
+			keys[i].rpo = n + i;
+
+	// loop nesting
+	for(CFG::BlockIter b(cfg->blocks()); b; b++)
+	{
+		key_t& k = keys[b->index()];
+		LoopHeaderIter lh(*b);
+		if(lh)
+		{
+			k.nest_cfg = (*lh)->cfg()->index();
+			k.nest = (*lh)->index();
+		}
+		for(; lh; lh++)
+			k.depth++;
+	}
+}
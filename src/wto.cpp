@@ -0,0 +1,182 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#include <climits>
+#include <otawa/cfg/features.h>
+#include "debug.h"
+#include "pretty_printing.h"
+#include "wto.h"
+
+/**
+ * @class WTO
+ * @brief Weak topological order of a CFG, computed with Bourdoncle's recursive algorithm (made iterative).
+ * Components are loops that must be stabilized before proceeding to the next element.
+ */
+WTO::WTO(CFG* cfg) : cfg(cfg), _valid(true), num(0)
+{
+	visit(cfg->entry(), _components);
+	dfn.clear();
+}
+
+WTO::~WTO()
+{
+	clear(_components);
+}
+
+WTO::Component::~Component()
+{
+	WTO::clear(_body);
+}
+
+void WTO::clear(list_t& l)
+{
+	for(list_t::Iterator iter(l); iter; iter++)
+		delete *iter;
+	l.clear();
+}
+
+// pending call of visit (comp is NULL) or component (comp is the component being built)
+class WTO::Frame
+{
+public:
+	Frame(Block* v, list_t* partition, int head, Component* comp = NULL)
+		: v(v), partition(partition), comp(comp), e(v->outs()), head(head), loop(false) { }
+	Block* v;
+	list_t* partition; // where the result goes
+	Component* comp;
+	Block::EdgeIter e;
+	int head; // for a component, what the visit of its head returns
+	bool loop;
+};
+
+/**
+ * @brief Visit a vertex, and return the smallest depth-first number of the vertices it reaches in the stack.
+ * The recursion of Bourdoncle's algorithm (visit, and component calling visit) is done with an explicit stack of frames,
+ * so that the depth of the CFG is not limited by the call stack.
+ */
+int WTO::visit(Block* root, list_t& root_partition)
+{
+	elm::genstruct::SLList<Frame*> frames;
+	stack.addFirst(root);
+	dfn.put(root, ++num);
+	frames.addFirst(new Frame(root, &root_partition, num));
+	int ret = 0; // what the last finished frame returned
+	bool returned = false;
+	while(frames)
+	{
+		Frame* f = frames.first();
+		if(returned)
+		{	// back from a visit of the target of f->e
+			returned = false;
+			if(!f->comp && ret <= f->head)
+			{
+				f->head = ret;
+				f->loop = true;
+			}
+			f->e++;
+			continue;
+		}
+		if(f->e)
+		{
+			Block* w = f->e->target();
+			const int d = w->cfg() == cfg ? dfn.get(w, 0) : -1;
+			if(d == 0)
+			{	// visit(w, ...)
+				stack.addFirst(w);
+				dfn.put(w, ++num);
+				frames.addFirst(new Frame(w, f->comp ? &f->comp->_body : f->partition, num));
+				continue;
+			}
+			if(!f->comp && d > 0 && d <= f->head)
+			{
+				f->head = d;
+				f->loop = true;
+			}
+			f->e++;
+			continue;
+		}
+
+		// all successors done
+		frames.removeFirst();
+		if(f->comp)
+		{	// end of component(f->v, ...)
+			if(!otawa::LOOP_HEADER(f->v))
+				_valid = false;
+			f->partition->addFirst(f->comp);
+		}
+		else if(f->head == dfn.get(f->v, 0))
+		{
+			dfn.put(f->v, INT_MAX);
+			Block* elem = stack.first();
+			stack.removeFirst();
+			if(f->loop)
+			{
+				while(elem != f->v)
+				{
+					dfn.put(elem, 0);
+					elem = stack.first();
+					stack.removeFirst();
+				}
+				// component(v, ...), which returns to the caller of this visit
+				frames.addFirst(new Frame(f->v, f->partition, f->head, new Component(f->v, true)));
+				delete f;
+				continue;
+			}
+			else
+				f->partition->addFirst(new Component(f->v));
+		}
+		ret = f->head;
+		returned = true;
+		delete f;
+	}
+	return ret;
+}
+
+/**
+ * @fn elm::String WTO::toString(void) const;
+ * @brief Print the WTO with the usual parenthesized notation, ex: 1 2 (3 4 5) 6
+ */
+elm::String WTO::toString(void) const
+{
+	elm::String str;
+	toString(str, _components);
+	return str;
+}
+
+void WTO::toString(elm::String& str, const list_t& l)
+{
+	bool first = true;
+	for(list_t::Iterator iter(l); iter; iter++)
+	{
+		if(first) first = false; else
+			str = str.concat(CString(" "));
+		if((*iter)->isLoop())
+		{
+			str = _ << str << "(" << (*iter)->head();
+			if((*iter)->body())
+				str = str.concat(CString(" "));
+			toString(str, (*iter)->body());
+			str = str.concat(CString(")"));
+		}
+		else
+			str = _ << str << (*iter)->head();
+	}
+}
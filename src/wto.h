@@ -0,0 +1,76 @@
+/*
+ *	
+ *
+ *	This file is part of OTAWA
+ *	Copyright (c) 2006-2018, IRIT UPS.
+ * 
+ *	OTAWA is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation; either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	OTAWA is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with OTAWA; if not, write to the Free Software 
+ *	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+ 
+#ifndef _WTO_H
+#define _WTO_H
+
+#include <elm/genstruct/SLList.h>
+#include <elm/genstruct/HashTable.h>
+#include <otawa/cfg/CFG.h>
+
+using otawa::Block;
+using otawa::CFG;
+
+/**
+ * Weak topological order of the blocks of a CFG (Bourdoncle, 1993)
+ */
+class WTO
+{
+public:
+	// either a single vertex (empty body) or a component headed by head
+	class Component
+	{
+	public:
+		Component(Block* head, bool loop = false) : _head(head), _loop(loop) { }
+		~Component();
+		inline Block* head(void) const { return _head; }
+		inline bool isLoop(void) const { return _loop; }
+		inline const elm::genstruct::SLList<Component*>& body(void) const { return _body; }
+		friend class WTO;
+	private:
+		Block* _head;
+		bool _loop;
+		elm::genstruct::SLList<Component*> _body;
+	};
+	typedef elm::genstruct::SLList<Component*> list_t;
+
+	WTO(CFG* cfg);
+	~WTO();
+	inline const list_t& components(void) const { return _components; }
+	inline bool isValid(void) const { return _valid; }
+	elm::String toString(void) const;
+	friend io::Output& operator<<(io::Output& out, const WTO& wto) { return out << wto.toString(); }
+
+private:
+	class Frame;
+	int visit(Block* root, list_t& root_partition);
+	static void toString(elm::String& str, const list_t& l);
+	static void clear(list_t& l);
+
+	CFG* cfg;
+	list_t _components;
+	bool _valid; // all component heads are loop headers (false on irreducible CFGs)
+	elm::genstruct::HashTable<Block*, int> dfn;
+	elm::genstruct::SLList<Block*> stack;
+	int num;
+};
+
+#endif
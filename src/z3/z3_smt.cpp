@@ -51,7 +51,10 @@ void Z3SMT::initialize(const SLList<LabelledPredicate>& labelled_preds)
 // check predicates satisfiability
 bool Z3SMT::checkPredSat()
 {
-	return s.check();
+	const z3::check_result result = s.check();
+	if(result == z3::unknown)
+		status = UNKNOWN;
+	return result; // unknown is taken as sat
 }
 
 // get unsat core and build a shortened path accordingly